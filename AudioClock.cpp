@@ -0,0 +1,128 @@
+// AudioClock: How far playback has got, measured by the audio device itself. The audio thread calls
+//             Advance each time it hands the device a block of frames; any other thread can read the
+//             position at the same time without taking a lock. Between blocks, the position is
+//             carried forward by the time since the last block, so it moves smoothly even when the
+//             device asks for data in large blocks. A block is not heard the moment it is handed over,
+//             but once what the device already holds has played out, so the position is held back by
+//             that latency.
+
+#include "AudioClock.h"
+#include <SDL/SDL.h>
+using namespace std;
+
+AudioClock::AudioClock()
+// POST: A stopped clock at position 0 with a sample rate of 44100 Hz
+{
+    sequence = 0;
+    running = false;
+    latency = 0;
+    Reset(44100);
+}
+
+void AudioClock::Reset(int sampleRate)
+// PRE:  sampleRate > 0, Advance is not running on another thread
+// POST: The clock is stopped at position 0, counting sampleRate frames per second.
+{
+    running = false;
+    this->sampleRate = sampleRate;
+
+    sequence++;                                     //readers retry until the fields are consistent again
+    framesDone = 0;
+    blockFrames = 0;
+    blockTicks = SDL_GetTicks();
+    sequence++;
+}
+
+void AudioClock::Seek(long frame)
+// PRE:  frame >= 0, Advance is not running on another thread
+// POST: The position is frame, and the next block passed to Advance carries on from there.
+{
+    sequence++;                                     //readers see the old position or the new one, not a mix
+    framesDone = frame;
+    blockFrames = 0;                                //nothing to interpolate until the next block
+    blockTicks = SDL_GetTicks();
+    sequence++;
+}
+
+void AudioClock::SetLatency(int frames)
+// PRE:  frames >= 0
+// POST: The position is reported frames frames behind what has been handed to the device.
+{
+    latency = frames;
+}
+
+int AudioClock::GetLatency() const
+// POST: FCTVAL == the frames the position is held back by
+{
+    return latency;
+}
+
+void AudioClock::SetRunning(bool running)
+// POST: If running, blocks passed to Advance move the clock forward; otherwise they are ignored
+//       and the clock holds still, as while the audio is paused.
+{
+    this->running = running;
+}
+
+void AudioClock::Advance(int frames, int restart, long from)
+// PRE:  Called from one thread only (the audio thread), frames >= 0, restart < frames, from >= 0
+// POST: If the clock is running, the device has been given frames more frames, and the position
+//       has moved on by that many. If restart >= 0, the frame restart frames into the block is frame
+//       from of a new song, and the position counts in that song instead (never before its start).
+{
+    if (!running && blockFrames == 0)               //paused, and the last block of music has been counted
+        return;
+
+    sequence.fetch_add(1, memory_order_relaxed);    //odd: fields are changing
+    atomic_thread_fence(memory_order_release);
+    if (restart >= 0 && running)                    //the new song is heard once the rest of the old one is
+        framesDone.store(from-restart, memory_order_relaxed);
+    else
+        framesDone.store(framesDone.load(memory_order_relaxed) + blockFrames.load(memory_order_relaxed),
+                         memory_order_relaxed);     //the previous block has now played out
+    if (running)
+    {
+        blockFrames.store(frames, memory_order_relaxed);
+        blockTicks.store(SDL_GetTicks(), memory_order_relaxed);
+    }
+    else                                            //paused: only silence from here, so stop interpolating
+        blockFrames.store(0, memory_order_relaxed);
+    sequence.fetch_add(1, memory_order_release);    //even: fields are consistent
+}
+
+double AudioClock::GetSeconds() const
+// POST: FCTVAL == the playback position in seconds, interpolated since the last block, less the
+//                 latency, and never past the end of that block or before 0
+{
+    unsigned int before;                            //sequence number before and after reading the fields
+    unsigned int after;
+    long frames;                                    //frames before the last block
+    int block;                                      //frames in the last block
+    unsigned int ticks;                             //when the last block was handed over
+    double played;                                  //frames of the last block played since then
+
+    do                                              //read until Advance did not run in the meantime
+    {
+        before = sequence.load(memory_order_acquire);
+        frames = framesDone.load(memory_order_relaxed);
+        block = blockFrames.load(memory_order_relaxed);
+        ticks = blockTicks.load(memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = sequence.load(memory_order_relaxed);
+    } while (before != after || before%2 == 1);
+
+    played = (SDL_GetTicks()-ticks)/1000.0*sampleRate;
+    if (played > block)
+        played = block;
+    played -= latency;                              //what the device held before the block is heard first
+    if (frames+played < 0)                          //still playing out the end of the song before
+        return 0;
+
+    return (frames+played)/sampleRate;
+}
+
+int AudioClock::GetMilliSeconds() const
+// POST: FCTVAL == GetSeconds(), in whole milliseconds
+{
+    return GetSeconds()*1000;
+}
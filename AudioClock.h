@@ -0,0 +1,61 @@
+// AudioClock: How far playback has got, measured by the audio device itself. The audio thread calls
+//             Advance each time it hands the device a block of frames; any other thread can read the
+//             position at the same time without taking a lock. Between blocks, the position is
+//             carried forward by the time since the last block, so it moves smoothly even when the
+//             device asks for data in large blocks. A block is not heard the moment it is handed over,
+//             but once what the device already holds has played out, so the position is held back by
+//             that latency.
+
+#pragma once
+
+#include <atomic>
+using namespace std;
+
+class AudioClock
+{
+public:
+    AudioClock();
+    // POST: A stopped clock at position 0 with a sample rate of 44100 Hz
+
+    void Reset(int sampleRate);
+    // PRE:  sampleRate > 0, Advance is not running on another thread
+    // POST: The clock is stopped at position 0, counting sampleRate frames per second.
+
+    void Seek(long frame);
+    // PRE:  frame >= 0, Advance is not running on another thread
+    // POST: The position is frame, and the next block passed to Advance carries on from there.
+
+    void SetLatency(int frames);
+    // PRE:  frames >= 0
+    // POST: The position is reported frames frames behind what has been handed to the device.
+
+    int GetLatency() const;
+    // POST: FCTVAL == the frames the position is held back by
+
+    void SetRunning(bool running);
+    // POST: If running, blocks passed to Advance move the clock forward; otherwise they are ignored
+    //       and the clock holds still, as while the audio is paused.
+
+    void Advance(int frames, int restart = -1, long from = 0);
+    // PRE:  Called from one thread only (the audio thread), frames >= 0, restart < frames, from >= 0
+    // POST: If the clock is running, the device has been given frames more frames, and the position
+    //       has moved on by that many. If restart >= 0, the frame restart frames into the block is frame
+    //       from of a new song, and the position counts in that song instead (never before its start).
+
+    double GetSeconds() const;
+    // POST: FCTVAL == the playback position in seconds, interpolated since the last block, less the
+    //                 latency, and never past the end of that block or before 0
+
+    int GetMilliSeconds() const;
+    // POST: FCTVAL == GetSeconds(), in whole milliseconds
+
+private:
+    atomic<unsigned int> sequence;          //odd while Advance is writing the fields below
+    atomic<long> framesDone;                //frames of the song handed to the device before the last block;
+                                            //  negative if the song starts partway through it
+    atomic<int> blockFrames;                //frames in the last block, or 0 after a pause
+    atomic<unsigned int> blockTicks;        //SDL_GetTicks() when the last block was handed over
+    atomic<bool> running;                   //true while blocks should be counted
+    atomic<int> latency;                    //frames between a frame being handed over and it being heard
+    atomic<int> sampleRate;                 //frames per second
+};
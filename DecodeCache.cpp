@@ -0,0 +1,264 @@
+// DecodeCache: Keeps the PCM ffmpeg decodes from compressed songs on disk, under $XDG_CACHE_HOME/GLUI
+//              (or ~/.cache/GLUI), so a song decoded once is read back by mapping a file instead of
+//              running ffmpeg again. Entries are named by a hash of the song's path, size and time of
+//              last change, so a song that is edited or replaced is decoded afresh. Each holds a short
+//              header and then the 16-bit samples as ffmpeg wrote them. Once the cache grows past
+//              DECODE_CACHE_BYTES, the entries used longest ago are removed. Safe to use from several
+//              threads at once.
+
+#include "DecodeCache.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+const char DECODE_CACHE_MAGIC[] = "GLUIPCM1";      //first 8 bytes of every entry; change it if the layout changes
+
+struct CacheFile                                    //an entry, as Trim sees it
+{
+    string name;
+    long long bytes;
+    time_t used;                                    //last changed, or last loaded
+};
+
+static bool UsedBefore(const CacheFile& a, const CacheFile& b)
+// POST: FCTVAL == true iff a was used before b
+{
+    return a.used < b.used;
+}
+
+DecodeCache::DecodeCache()
+// POST: A cache in $XDG_CACHE_HOME/GLUI (or ~/.cache/GLUI), made if need be. If there is nowhere to
+//       put it, every lookup misses and nothing is stored.
+{
+    const char* base = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    if (base && *base)
+        directory = string(base) + "/GLUI";
+    else if (home && *home)
+    {
+        mkdir((string(home) + "/.cache").c_str(), 0700);   //usually there already
+        directory = string(home) + "/.cache/GLUI";
+    }
+
+    if (!directory.empty() && mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST)
+        directory.clear();                          //nowhere to keep it
+}
+
+Wave* DecodeCache::Load(string fileName)
+// POST: FCTVAL == a new Wave holding the PCM cached for the song at fileName, or NULL if none is
+//       cached for it as it is now. A hit counts as a use of the entry.
+{
+    string entry = EntryName(fileName);
+    struct stat info;
+    unsigned char* data;                            //the entry, mapped
+    int32_t sampleRate;                             //from its header
+    int32_t numChannels;
+    int64_t frames;
+    Wave* song;
+    int fd;
+
+    if (entry.empty() || (fd = open(entry.c_str(), O_RDONLY | O_CLOEXEC)) < 0)
+        return NULL;
+
+    if (fstat(fd, &info) != 0 || info.st_size < DECODE_CACHE_HEADER)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    data = static_cast<unsigned char*>(mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+    close(fd);                                      //the mapping lasts without it
+    if (data == MAP_FAILED)
+        return NULL;
+
+    memcpy(&sampleRate, data+8, 4);
+    memcpy(&numChannels, data+12, 4);
+    memcpy(&frames, data+16, 8);
+
+    if (memcmp(data, DECODE_CACHE_MAGIC, 8) != 0 || sampleRate <= 0 || numChannels <= 0 || frames <= 0
+        || DECODE_CACHE_HEADER + frames*numChannels*2 != info.st_size)
+    {
+        munmap(data, info.st_size);
+        unlink(entry.c_str());                      //cut short or from another version: decode again
+        return NULL;
+    }
+
+    madvise(data, info.st_size, MADV_SEQUENTIAL);   //read once, front to back
+    song = new Wave(fileName.c_str(), sampleRate, numChannels);
+    song->AppendPCM(data+DECODE_CACHE_HEADER, frames);
+    munmap(data, info.st_size);
+
+    utime(entry.c_str(), NULL);                     //used now, so trimmed last
+    return song;
+}
+
+int DecodeCache::Create(string& tempName)
+// POST: FCTVAL == a descriptor open for writing on a new file in the cache, named tempName, with
+//       room for the header written; -1 if the cache cannot be written to.
+{
+    unsigned char blank[DECODE_CACHE_HEADER] = { 0 };      //filled in by Store
+    vector<char> name;                              //mkostemp fills in the X's
+    int fd;
+
+    if (directory.empty())
+        return -1;
+
+    tempName = directory + "/tmp-XXXXXX";           //not .pcm, so Trim leaves it be while it is written
+    name.assign(tempName.begin(), tempName.end());
+    name.push_back('\0');
+    fd = mkostemp(&name[0], O_CLOEXEC);             //not for an ffmpeg started meanwhile to inherit
+    if (fd < 0)
+        return -1;
+
+    tempName = &name[0];
+    if (!Append(fd, blank, DECODE_CACHE_HEADER))
+    {
+        Discard(fd, tempName);
+        return -1;
+    }
+
+    return fd;
+}
+
+bool DecodeCache::Append(int fd, const unsigned char* data, long bytes)
+// PRE:  fd is from Create
+// POST: data[0..bytes-1] follows what was written to fd before. FCTVAL == true iff it all was.
+{
+    ssize_t wrote;
+
+    while (bytes > 0)
+    {
+        wrote = write(fd, data, bytes);
+        if (wrote < 0 && errno != EINTR)            //disk full, say
+            return false;
+        if (wrote > 0)
+        {
+            data += wrote;
+            bytes -= wrote;
+        }
+    }
+
+    return true;
+}
+
+void DecodeCache::Store(string entry, int fd, string tempName, int sampleRate, int numChannels, long frames)
+// PRE:  fd and tempName are from Create, and frames frames of numChannels channels of 16-bit little
+//       endian PCM at sampleRate Hz have been appended to fd, decoded from a song whose EntryName was
+//       entry before the decode began
+// POST: fd is closed and the file is the cache entry named entry, unless entry is "". Entries used
+//       longest ago have been removed until the cache fits in DECODE_CACHE_BYTES.
+{
+    unsigned char header[DECODE_CACHE_HEADER];
+    int32_t rate = sampleRate;                      //fixed sizes, so the layout is the same everywhere
+    int32_t channels = numChannels;
+    int64_t count = frames;
+
+    memcpy(header, DECODE_CACHE_MAGIC, 8);
+    memcpy(header+8, &rate, 4);
+    memcpy(header+12, &channels, 4);
+    memcpy(header+16, &count, 8);
+
+    if (entry.empty() || pwrite(fd, header, DECODE_CACHE_HEADER, 0) != DECODE_CACHE_HEADER)
+    {
+        Discard(fd, tempName);
+        return;
+    }
+
+    close(fd);
+    if (rename(tempName.c_str(), entry.c_str()) != 0)      //whole, or not there at all
+    {
+        unlink(tempName.c_str());
+        return;
+    }
+
+    Trim();
+}
+
+void DecodeCache::Discard(int fd, string tempName)
+// PRE:  fd and tempName are from Create
+// POST: fd is closed and its file removed.
+{
+    close(fd);
+    unlink(tempName.c_str());
+}
+
+string DecodeCache::EntryName(string fileName) const
+// POST: FCTVAL == the path of the cache entry for the song at fileName as it is now, or "" if
+//       there is no cache or the song cannot be found
+{
+    struct stat info;
+    string key;                                     //what the entry stands for
+    uint64_t hash = 14695981039346656037ULL;        //FNV-1a
+    char name[21];
+
+    if (directory.empty() || stat(fileName.c_str(), &info) != 0)
+        return "";
+
+    key = fileName + '\0' + to_string((long long)info.st_size) + '\0' + to_string((long long)info.st_mtime);
+    for (unsigned int i=0; i < key.length(); i++)
+    {
+        hash ^= (unsigned char)key[i];
+        hash *= 1099511628211ULL;
+    }
+
+    snprintf(name, sizeof(name), "%016llx.pcm", (unsigned long long)hash);
+    return directory + "/" + name;
+}
+
+void DecodeCache::Trim()
+// POST: Entries used longest ago have been removed until the cache fits in DECODE_CACHE_BYTES, and
+//       half-written ones untouched for DECODE_CACHE_STALE seconds have been removed.
+{
+    lock_guard<mutex> lock(trimLock);
+    vector<CacheFile> files;
+    long long total = 0;                            //bytes in the cache
+    DIR* dir = opendir(directory.c_str());
+    struct dirent* found;
+    struct stat info;
+    CacheFile file;
+    time_t now = time(NULL);
+
+    if (!dir)
+        return;
+
+    while ((found = readdir(dir)) != NULL)
+    {
+        file.name = directory + "/" + found->d_name;
+        if (strncmp(found->d_name, "tmp-", 4) == 0)         //left by a decode that was killed or crashed,
+        {                                                   //  unless it is still being written
+            if (stat(file.name.c_str(), &info) == 0 && now - info.st_mtime > DECODE_CACHE_STALE)
+                unlink(file.name.c_str());
+            continue;
+        }
+        if (file.name.length() < 4 || file.name.compare(file.name.length()-4, 4, ".pcm") != 0
+            || stat(file.name.c_str(), &info) != 0)
+            continue;
+
+        file.bytes = info.st_size;
+        file.used = info.st_mtime;
+        files.push_back(file);
+        total += file.bytes;
+    }
+    closedir(dir);
+
+    sort(files.begin(), files.end(), UsedBefore);
+    for (unsigned int i=0; i < files.size() && total > DECODE_CACHE_BYTES; i++)
+    {
+        unlink(files[i].name.c_str());
+        total -= files[i].bytes;
+    }
+}
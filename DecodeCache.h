@@ -0,0 +1,62 @@
+// DecodeCache: Keeps the PCM ffmpeg decodes from compressed songs on disk, under $XDG_CACHE_HOME/GLUI
+//              (or ~/.cache/GLUI), so a song decoded once is read back by mapping a file instead of
+//              running ffmpeg again. Entries are named by a hash of the song's path, size and time of
+//              last change, so a song that is edited or replaced is decoded afresh. Each holds a short
+//              header and then the 16-bit samples as ffmpeg wrote them. Once the cache grows past
+//              DECODE_CACHE_BYTES, the entries used longest ago are removed. Safe to use from several
+//              threads at once.
+
+#pragma once
+
+#include <string>
+#include <mutex>
+#include "Wave/Wave.h"
+using namespace std;
+
+const long long DECODE_CACHE_BYTES = 2LL << 30;    //most the cache holds: about three hours of CD audio
+const int DECODE_CACHE_HEADER = 24;                 //bytes before the samples of an entry
+const int DECODE_CACHE_STALE = 24*60*60;            //seconds after which a half-written entry is taken to be
+                                                    //  left over from a decode that never finished
+
+class DecodeCache
+{
+public:
+    DecodeCache();
+    // POST: A cache in $XDG_CACHE_HOME/GLUI (or ~/.cache/GLUI), made if need be. If there is nowhere to
+    //       put it, every lookup misses and nothing is stored.
+
+    Wave* Load(string fileName);
+    // POST: FCTVAL == a new Wave holding the PCM cached for the song at fileName, or NULL if none is
+    //       cached for it as it is now. A hit counts as a use of the entry.
+
+    int Create(string& tempName);
+    // POST: FCTVAL == a descriptor open for writing on a new file in the cache, named tempName, with
+    //       room for the header written; -1 if the cache cannot be written to.
+
+    bool Append(int fd, const unsigned char* data, long bytes);
+    // PRE:  fd is from Create
+    // POST: data[0..bytes-1] follows what was written to fd before. FCTVAL == true iff it all was.
+
+    void Store(string entry, int fd, string tempName, int sampleRate, int numChannels, long frames);
+    // PRE:  fd and tempName are from Create, and frames frames of numChannels channels of 16-bit little
+    //       endian PCM at sampleRate Hz have been appended to fd, decoded from a song whose EntryName was
+    //       entry before the decode began
+    // POST: fd is closed and the file is the cache entry named entry, unless entry is "". Entries used
+    //       longest ago have been removed until the cache fits in DECODE_CACHE_BYTES.
+
+    void Discard(int fd, string tempName);
+    // PRE:  fd and tempName are from Create
+    // POST: fd is closed and its file removed.
+
+    string EntryName(string fileName) const;
+    // POST: FCTVAL == the path of the cache entry for the song at fileName as it is now, or "" if
+    //       there is no cache or the song cannot be found
+
+private:
+    void Trim();
+    // POST: Entries used longest ago have been removed until the cache fits in DECODE_CACHE_BYTES, and
+    //       half-written ones untouched for DECODE_CACHE_STALE seconds have been removed.
+
+    string directory;       //where the entries are kept, or "" if nowhere
+    mutex trimLock;         //one trim at a time
+};
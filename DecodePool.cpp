@@ -0,0 +1,229 @@
+// DecodePool - Decodes songs into memory on a small pool of worker threads, so the GUI never waits on a
+//              file being read. Compressed songs (.mp3, .m4a) are piped from ffmpeg as raw PCM, already at
+//              the rate and channels the player plays at, and kept in a DecodeCache so they are only piped
+//              once. Each song is handed back, by its track number, as soon as it is decoded, and progress
+//              over the whole batch is reported as it goes. Signals are emitted on the GUI thread.
+
+#include "DecodePool.h"
+#include <QMetaObject>
+#include <QMetaType>
+#include <QRunnable>
+#include <QThread>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+#include <mutex>
+using namespace std;
+
+extern char** environ;                          //passed on to ffmpeg
+
+static mutex spawnLock;                         //held from making a pipe until its write end is closed here, so
+                                                //  no other ffmpeg is started holding it open
+
+class DecodeJob : public QRunnable					//one decode, run by the pool
+{
+public:
+	DecodeJob(DecodePool* owner, int track, string fileName, int batch)
+		: owner(owner), track(track), fileName(fileName), batch(batch)
+	//POST: A job decoding fileName for track track of batch batch of owner
+	{
+	}
+
+	void run()
+	//POST: Run on a worker thread: fileName has been decoded, and owner handed the song on its own thread.
+	{
+		Wave* song = owner->load(fileName);
+
+		QMetaObject::invokeMethod(owner, "finished", Qt::QueuedConnection,
+								  Q_ARG(int, track), Q_ARG(Wave*, song), Q_ARG(int, batch));
+	}
+
+private:
+	DecodePool* owner;
+	int track;
+	string fileName;
+	int batch;
+};
+
+DecodePool::DecodePool(QObject* parent) : QObject(parent)
+//PRE: The QObject referenced by parent is initialized
+//POST: An idle pool, running up to MAX_DECODE_THREADS decodes at once (fewer on fewer cores)
+{
+	qRegisterMetaType<Wave*>("Wave*");				//so songs can be queued across threads
+	pool.setMaxThreadCount(max(1, min(QThread::idealThreadCount(), MAX_DECODE_THREADS)));
+	batch = 0;
+	done = 0;
+	total = 0;
+}
+
+DecodePool::~DecodePool()
+//POST: Decodes not yet started have been dropped, and those under way have finished.
+{
+	cancel();
+	pool.waitForDone();			//the jobs call back into us
+}
+
+void DecodePool::decode(int track, string fileName)
+//PRE: fileName is the path of a .wav, .mp3 or .m4a file
+//POST: A decode of fileName has been queued. trackReady(track, ...) follows once it has run.
+{
+	total++;
+	emit progress(done, total);
+	pool.start(new DecodeJob(this, track, fileName, batch));	//the pool deletes it once run
+}
+
+void DecodePool::cancel()
+//POST: Decodes not yet started have been dropped, the ffmpegs of those under way have been told to
+//		stop, and no signal is emitted for any of them. Progress starts again from nothing.
+{
+	pool.clear();				//drop what has not started,
+	{							//and cut short what has, without waiting on it
+		lock_guard<mutex> lock(runningLock);
+		for (set<pid_t>::iterator i = running.begin(); i != running.end(); i++)
+			kill(*i, SIGTERM);
+	}
+	batch++;					//their finished calls are still on the way, and are dropped
+	done = 0;
+	total = 0;
+}
+
+Wave* DecodePool::load(string fileName)
+//PRE: fileName is the path of a .wav, .mp3 or .m4a file; for the last two, ffmpeg is on the path
+//POST: FCTVAL == a new Wave holding the song, from the cache if it is there, or NULL if ffmpeg could
+//		not decode it. Safe to call on any thread.
+{
+	string extension = fileName.substr(fileName.length()-3, 3);
+	Wave* song;
+
+	if (extension == "mp3" || extension == "m4a")
+	{
+		song = cache.Load(fileName);			//decoded before: no need for ffmpeg
+		return song ? song : pipeFromFfmpeg(fileName);
+	}
+
+	return new Wave(fileName.c_str());
+}
+
+Wave* DecodePool::pipeFromFfmpeg(string fileName)
+//PRE: ffmpeg is on the path
+//POST: FCTVAL == a new Wave of DECODE_CHANNELS channels at DECODE_RATE, holding the PCM ffmpeg wrote to
+//		a pipe while decoding fileName, or NULL if it failed or wrote none. The PCM has been cached
+//		for fileName as it came, if it all came.
+{
+	string rate = to_string(DECODE_RATE);
+	string channels = to_string(DECODE_CHANNELS);
+	const char* args[] = { "ffmpeg", "-nostdin", "-loglevel", "error", "-i", fileName.c_str(), "-vn",
+						   "-f", "s16le", "-acodec", "pcm_s16le", "-ar", rate.c_str(), "-ac", channels.c_str(),
+						   "-", NULL };	//no shell, so the file name needs no quoting
+	const int frameBytes = 2*DECODE_CHANNELS;	//one 16-bit sample per channel
+	unsigned char buffer[PIPE_BUFFER_BYTES];	//PCM read but not yet added to the song
+	int have = 0;								//bytes of it
+	int spare;									//bytes of a frame not yet whole
+	ssize_t got;
+	int fds[2];									//read and write ends of the pipe
+	posix_spawn_file_actions_t actions;
+	pid_t pid;
+	int status;
+	Wave* song;
+	string entry;								//cache entry for the song as it was before decoding, so
+												//  one changed meanwhile is not stored under its new name
+	string tempName;							//cache entry being written
+	int cached;									//open on it, or -1 if not caching
+
+	entry = cache.EntryName(fileName);
+
+	{
+		lock_guard<mutex> lock(spawnLock);
+
+		if (pipe(fds) != 0)
+			return NULL;
+		fcntl(fds[0], F_SETFD, FD_CLOEXEC);		//ffmpeg sees the write end only as its stdout
+		fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+		{
+			lock_guard<mutex> lock(runningLock);	//so cancel cannot miss it between starting and listing it
+			status = posix_spawnp(&pid, "ffmpeg", &actions, NULL, const_cast<char* const*>(args), environ);
+			if (status == 0)
+				running.insert(pid);
+		}
+		posix_spawn_file_actions_destroy(&actions);
+		close(fds[1]);							//so the read end sees ffmpeg finish
+	}
+
+	if (status != 0)							//ffmpeg is not installed
+	{
+		close(fds[0]);
+		return NULL;
+	}
+
+	song = new Wave(fileName.c_str(), DECODE_RATE, DECODE_CHANNELS);
+	cached = entry.empty() ? -1 : cache.Create(tempName);
+	while ((got = read(fds[0], buffer+have, PIPE_BUFFER_BYTES-have)) != 0)
+	{
+		if (got < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;								//ffmpeg is stopped by SIGPIPE once we close our end
+		}
+
+		have += got;
+		song->AppendPCM(buffer, have/frameBytes);
+		if (cached != -1 && !cache.Append(cached, buffer, have - have % frameBytes))
+		{
+			cache.Discard(cached, tempName);	//out of room: play it anyway
+			cached = -1;
+		}
+		spare = have % frameBytes;				//keep a split frame for the next read
+		memmove(buffer, buffer+have-spare, spare);
+		have = spare;
+	}
+	close(fds[0]);
+
+	{
+		lock_guard<mutex> lock(runningLock);
+		running.erase(pid);						//before it is reaped, so its pid is never reused under cancel
+	}
+	while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+		;
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || song->GetSamplesPerChannel() == 0)
+	{
+		if (cached != -1)
+			cache.Discard(cached, tempName);
+		delete song;
+		return NULL;
+	}
+
+	if (cached != -1)
+		cache.Store(entry, cached, tempName, DECODE_RATE, DECODE_CHANNELS, song->GetSamplesPerChannel());
+	return song;
+}
+
+void DecodePool::finished(int track, Wave* song, int batch)
+//POST: Run on the GUI thread by each worker as its decode ends. Unless the pool has been cancelled
+//		since it was queued (batch is not the current one), the decode has been counted, and
+//		trackReady and progress emitted; otherwise song has been deleted.
+{
+	if (batch != this->batch)	//cancelled
+	{
+		delete song;
+		return;
+	}
+
+	done++;
+	emit trackReady(track, song);
+	emit progress(done, total);
+	if (done == total)			//idle: the next batch counts from nothing
+	{
+		done = 0;
+		total = 0;
+	}
+}
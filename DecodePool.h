@@ -0,0 +1,76 @@
+// DecodePool - Decodes songs into memory on a small pool of worker threads, so the GUI never waits on a
+//              file being read. Compressed songs (.mp3, .m4a) are piped from ffmpeg as raw PCM, already at
+//              the rate and channels the player plays at, and kept in a DecodeCache so they are only piped
+//              once. Each song is handed back, by its track number, as soon as it is decoded, and progress
+//              over the whole batch is reported as it goes. Signals are emitted on the GUI thread.
+
+#pragma once
+#include <QObject>
+#include <QThreadPool>
+#include <string>
+#include <set>
+#include <mutex>
+#include <sys/types.h>
+#include "Wave/Wave.h"
+#include "DecodeCache.h"
+using namespace std;
+
+const int MAX_DECODE_THREADS = 4;               //most decodes run at once; ffmpeg uses threads of its own
+const int DECODE_RATE = 44100;                  //ffmpeg's output: the player's device format, so it has
+const int DECODE_CHANNELS = 2;                  //  nothing to convert
+const int PIPE_BUFFER_BYTES = 65536;            //read from ffmpeg this much at a time
+
+class DecodePool : public QObject
+{
+	Q_OBJECT
+
+public:
+	DecodePool(QObject* parent);
+	//PRE: The QObject referenced by parent is initialized
+	//POST: An idle pool, running up to MAX_DECODE_THREADS decodes at once (fewer on fewer cores)
+
+	~DecodePool();
+	//POST: Decodes not yet started have been dropped, and those under way have finished.
+
+	void decode(int track, string fileName);
+	//PRE: fileName is the path of a .wav, .mp3 or .m4a file
+	//POST: A decode of fileName has been queued. trackReady(track, ...) follows once it has run.
+
+	void cancel();
+	//POST: Decodes not yet started have been dropped, the ffmpegs of those under way have been told to
+	//		stop, and no signal is emitted for any of them. Progress starts again from nothing.
+
+	Wave* load(string fileName);
+	//PRE: fileName is the path of a .wav, .mp3 or .m4a file; for the last two, ffmpeg is on the path
+	//POST: FCTVAL == a new Wave holding the song, from the cache if it is there, or NULL if ffmpeg could
+	//		not decode it. Safe to call on any thread.
+
+signals:
+	void trackReady(int track, Wave* song);
+	//Emitted when the decode queued for track has run. The receiver owns song, which is NULL if it failed.
+
+	void progress(int done, int total);
+	//Emitted as each decode finishes: done of the total queued since the pool was last idle have run.
+	//done == total once they all have.
+
+private slots:
+	void finished(int track, Wave* song, int batch);
+	//POST: Run on the GUI thread by each worker as its decode ends. Unless the pool has been cancelled
+	//		since it was queued (batch is not the current one), the decode has been counted, and
+	//		trackReady and progress emitted; otherwise song has been deleted.
+
+private:
+	Wave* pipeFromFfmpeg(string fileName);
+	//PRE: ffmpeg is on the path
+	//POST: FCTVAL == a new Wave of DECODE_CHANNELS channels at DECODE_RATE, holding the PCM ffmpeg wrote to
+	//		a pipe while decoding fileName, or NULL if it failed or wrote none. The PCM has been cached
+	//		for fileName as it came, if it all came.
+
+	QThreadPool pool;	//threads running the decodes
+	DecodeCache cache;	//songs decoded before
+	set<pid_t> running;	//ffmpegs decoding now, for cancel to stop
+	mutex runningLock;	//held to change or read running
+	int batch;			//counts the calls to cancel, so the results of cancelled decodes can be told apart
+	int done;			//decodes finished since the pool was last idle,
+	int total;			//  out of this many queued
+};
@@ -0,0 +1,146 @@
+// FrameProfiler: Keeps the timings of the last few hundred frames drawn in a ring buffer, along with
+//                counts of frames dropped and timer ticks that drew nothing. The GUI thread records
+//                frames; any thread can take a snapshot of them without a lock, to summarize them
+//                for the on-screen overlay or to save them as CSV.
+
+#include "FrameProfiler.h"
+#include <algorithm>
+#include <fstream>
+#include <math.h>
+#include <stdio.h>
+using namespace std;
+
+FrameProfiler::FrameProfiler()
+// POST: An empty profile expecting 60 frames per second
+{
+    Reset(60);
+}
+
+void FrameProfiler::Reset(int frameRate)
+// PRE:  frameRate > 0, Record and CountTick are not running on another thread
+// POST: All frames and counts are forgotten. Frames more than 1.5/frameRate seconds apart count
+//       as dropping the frames that should have come in between.
+{
+    period = 1000.0/frameRate;
+    written = 0;
+    ticks = 0;
+    idleTicks = 0;
+    totalDropped = 0;
+}
+
+void FrameProfiler::Record(FrameTiming frame)
+// PRE:  Called from one thread only, frame.interval >= 0 or frame.interval == -1
+// POST: frame is the newest frame kept, with frame.dropped set from its interval (none if it is
+//       -1). If CAPACITY frames were already kept, the oldest is gone.
+{
+    unsigned long n = written.load(memory_order_relaxed);     //number of the frame being recorded
+
+    frame.dropped = frame.interval > 1.5*period                 //late enough that a whole frame was skipped
+                  ? int(floor(frame.interval/period + 0.5)) - 1 : 0;
+    totalDropped.fetch_add(frame.dropped, memory_order_relaxed);
+
+    frames[n%CAPACITY] = frame;
+    written.store(n+1, memory_order_release);                   //publish it to Snapshot
+}
+
+void FrameProfiler::CountTick(bool drew)
+// PRE:  Called from the same thread as Record
+// POST: One more tick of the frame timer has been counted, and one more idle tick unless drew.
+{
+    ticks.fetch_add(1, memory_order_relaxed);
+    if (!drew)
+        idleTicks.fetch_add(1, memory_order_relaxed);
+}
+
+int FrameProfiler::Snapshot(vector<FrameTiming>& frames) const
+// POST: frames holds the frames kept, oldest first, leaving out any that Record overwrote while
+//       they were being copied. FCTVAL == frames.size()
+{
+    unsigned long end = written.load(memory_order_acquire);    //one past the newest frame
+    unsigned long begin = end > CAPACITY ? end-CAPACITY : 0;    //the oldest frame kept
+    unsigned long after;                                        //one past the last frame that may have been
+                                                                //  touched during the copy
+
+    frames.clear();
+    for (unsigned long n=begin; n < end; n++)
+        frames.push_back(this->frames[n%CAPACITY]);
+
+    atomic_thread_fence(memory_order_acquire);
+    after = written.load(memory_order_relaxed) + 1;             //Record may be writing frame after-1 right now
+    if (after > begin+CAPACITY)                                 //the oldest slots were reused during the copy
+        frames.erase(frames.begin(), frames.begin() + min<unsigned long>(after-begin-CAPACITY, frames.size()));
+
+    return frames.size();
+}
+
+vector<string> FrameProfiler::Summary() const
+// POST: FCTVAL == a few lines describing the frames kept: frame time and drift percentiles, time
+//       computing and submitting, frames dropped and idle ticks. Empty if no frames are kept.
+{
+    vector<FrameTiming> kept;               //the frames to summarize
+    vector<double> interval;                //each of their fields, for the percentiles
+    vector<double> compute;
+    vector<double> submit;
+    vector<double> drift;
+    vector<string> lines;
+    char line[128];
+
+    if (Snapshot(kept) == 0)
+        return lines;
+
+    for (unsigned int i=0; i < kept.size(); i++)
+    {
+        if (i > 0 && kept[i].interval >= 0) //the first frame kept has no frame before it in the ring, and
+            interval.push_back(kept[i].interval);   //  one after a pause has none it can be timed from
+        compute.push_back(kept[i].compute);
+        submit.push_back(kept[i].submit);
+        drift.push_back(kept[i].drift);
+    }
+    if (interval.empty())
+        interval.push_back(max(kept[0].interval, 0.0));
+
+    sprintf(line, "frame %.1f ms p50  %.1f p95  %.1f p99  %.1f max  (%d frames)",
+            Percentile(interval, 50), Percentile(interval, 95), Percentile(interval, 99),
+            Percentile(interval, 100), int(kept.size()));
+    lines.push_back(line);
+    sprintf(line, "cpu %.2f ms vertices  %.2f ms GL submit  (p50; p95 %.2f / %.2f)",
+            Percentile(compute, 50), Percentile(submit, 50), Percentile(compute, 95), Percentile(submit, 95));
+    lines.push_back(line);
+    sprintf(line, "dropped %ld frames, %ld of %ld timer ticks idle",
+            totalDropped.load(), idleTicks.load(), ticks.load());
+    lines.push_back(line);
+    sprintf(line, "a/v drift %+.1f ms p50  %+.1f p5  %+.1f p95",
+            Percentile(drift, 50), Percentile(drift, 5), Percentile(drift, 95));
+    lines.push_back(line);
+
+    return lines;
+}
+
+bool FrameProfiler::WriteCSV(const string& fileName) const
+// POST: The frames kept have been written to fileName, one line per frame under a header line.
+//       FCTVAL == true iff the file was written.
+{
+    vector<FrameTiming> kept;               //the frames to write
+    ofstream out(fileName.c_str());
+
+    Snapshot(kept);
+    out << "time_ms,interval_ms,compute_ms,submit_ms,drift_ms,dropped,visualization" << endl;
+    for (unsigned int i=0; i < kept.size(); i++)
+        out << kept[i].time << ',' << kept[i].interval << ',' << kept[i].compute << ','
+            << kept[i].submit << ',' << kept[i].drift << ',' << kept[i].dropped << ','
+            << kept[i].visualization << endl;
+
+    return bool(out);
+}
+
+double FrameProfiler::Percentile(vector<double> values, double p)
+// PRE:  values is not empty, 0 <= p <= 100
+// POST: FCTVAL == the value p% of the way through values in sorted order (nearest rank)
+{
+    unsigned int rank = ceil(p/100*values.size());            //1-based nearest rank
+
+    if (rank < 1)
+        rank = 1;
+    nth_element(values.begin(), values.begin()+rank-1, values.end());
+    return values[rank-1];
+}
@@ -0,0 +1,71 @@
+// FrameProfiler: Keeps the timings of the last few hundred frames drawn in a ring buffer, along with
+//                counts of frames dropped and timer ticks that drew nothing. The GUI thread records
+//                frames; any thread can take a snapshot of them without a lock, to summarize them
+//                for the on-screen overlay or to save them as CSV.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+using namespace std;
+
+class FrameTiming                           //how one frame went
+{
+public:
+    double time;                            //ms since profiling started when the frame was finished
+    double interval;                        //ms since the frame before it was finished, or -1 if none was
+                                            //  since profiling was reset or playback resumed
+    double compute;                         //ms spent working out the frame's vertices
+    double submit;                          //ms spent handing them to OpenGL
+    double drift;                           //ms the audio had played past the frame's first sample
+    int dropped;                            //frames that should have been drawn since the last one but were not
+    int visualization;                      //which visualization was drawn
+};
+
+class FrameProfiler
+{
+public:
+    static const int CAPACITY = 512;        //frames kept; older ones are overwritten
+
+    FrameProfiler();
+    // POST: An empty profile expecting 60 frames per second
+
+    void Reset(int frameRate);
+    // PRE:  frameRate > 0, Record and CountTick are not running on another thread
+    // POST: All frames and counts are forgotten. Frames more than 1.5/frameRate seconds apart count
+    //       as dropping the frames that should have come in between.
+
+    void Record(FrameTiming frame);
+    // PRE:  Called from one thread only, frame.interval >= 0 or frame.interval == -1
+    // POST: frame is the newest frame kept, with frame.dropped set from its interval (none if it is
+    //       -1). If CAPACITY frames were already kept, the oldest is gone.
+
+    void CountTick(bool drew);
+    // PRE:  Called from the same thread as Record
+    // POST: One more tick of the frame timer has been counted, and one more idle tick unless drew.
+
+    int Snapshot(vector<FrameTiming>& frames) const;
+    // POST: frames holds the frames kept, oldest first, leaving out any that Record overwrote while
+    //       they were being copied. FCTVAL == frames.size()
+
+    vector<string> Summary() const;
+    // POST: FCTVAL == a few lines describing the frames kept: frame time and drift percentiles, time
+    //       computing and submitting, frames dropped and idle ticks. Empty if no frames are kept.
+
+    bool WriteCSV(const string& fileName) const;
+    // POST: The frames kept have been written to fileName, one line per frame under a header line.
+    //       FCTVAL == true iff the file was written.
+
+    static double Percentile(vector<double> values, double p);
+    // PRE:  values is not empty, 0 <= p <= 100
+    // POST: FCTVAL == the value p% of the way through values in sorted order (nearest rank)
+
+private:
+    FrameTiming frames[CAPACITY];           //ring of frames; frame n is in frames[n%CAPACITY]
+    atomic<unsigned long> written;          //frames ever recorded; frames[written%CAPACITY] is next
+    atomic<long> ticks;                     //frame timer ticks since Reset
+    atomic<long> idleTicks;                 //ticks that found no new frame to draw
+    atomic<long> totalDropped;              //frames dropped since Reset
+    double period;                          //ms between frames at the requested frame rate
+};
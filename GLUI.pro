@@ -18,7 +18,31 @@ HEADERS += GLWidget.h \
            Wave/Timer.h \
            Wave/Turtle.h \
            Wave/Utility.h \
-           Wave/Wave.h
+           Wave/Wave.h \
+           Wave/Window.h \
+           Wave/Spectrogram.h \
+           Wave/SpectralCache.h \
+           Wave/SpectralProcessor.h \
+           Wave/Effect.h \
+           Wave/Convolver.h \
+           Wave/ConstantQ.h \
+           VertexBatch.h \
+           WaveShader.h \
+           SurfaceMesh.h \
+           AudioClock.h \
+           OffscreenRenderer.h \
+           VideoExporter.h \
+           FrameProfiler.h \
+           Visualization.h \
+           Visualizations.h \
+           RingBuffer.h \
+           Wave/EffectChain.h \
+           Wave/Equalizer.h \
+           Wave/PitchShifter.h \
+           Wave/Resampler.h \
+           Wave/ChannelMixer.h \
+           DecodePool.h \
+           DecodeCache.h
 SOURCES += GLWidget.cpp \
            main.cpp \
            MainWindow.cpp \
@@ -30,7 +54,31 @@ SOURCES += GLWidget.cpp \
            Wave/Timer.cpp \
            Wave/Turtle.cpp \
            Wave/Utility.cpp \
-           Wave/Wave.cpp
+           Wave/Wave.cpp \
+           Wave/Window.cpp \
+           Wave/Spectrogram.cpp \
+           Wave/SpectralCache.cpp \
+           Wave/SpectralProcessor.cpp \
+           Wave/Effect.cpp \
+           Wave/Convolver.cpp \
+           Wave/ConstantQ.cpp \
+           VertexBatch.cpp \
+           WaveShader.cpp \
+           SurfaceMesh.cpp \
+           AudioClock.cpp \
+           OffscreenRenderer.cpp \
+           VideoExporter.cpp \
+           FrameProfiler.cpp \
+           Visualization.cpp \
+           Visualizations.cpp \
+           Wave/EffectChain.cpp \
+           Wave/Equalizer.cpp \
+           Wave/PitchShifter.cpp \
+           Wave/Resampler.cpp \
+           Wave/ChannelMixer.cpp \
+           DecodePool.cpp \
+           DecodeCache.cpp
 RESOURCES += GLUI.qrc
 QT += opengl
-LIBS += -lSDL -lSDL_mixer -lglut -lGLU
+CONFIG += c++11
+LIBS += -lSDL -lglut -lGLU
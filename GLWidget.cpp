@@ -6,10 +6,9 @@
 #include <GL/glut.h>
 #include <math.h>
 #include <iostream>
-#include <complex>
 using namespace std; 
 
-GLWidget::GLWidget(QWidget* parent) : QGLWidget(parent)
+GLWidget::GLWidget(QWidget* parent) : QGLWidget(SyncedFormat(), parent)
 // POST: GLWidget constructed, with line color set to medium blue, visualization set to basic 
 //       waveform, and with widget able to handle keyboard and mouse events.
 {	
@@ -18,53 +17,147 @@ GLWidget::GLWidget(QWidget* parent) : QGLWidget(parent)
 	blue = 1.0;                     //blue component of line color for drawing
 	
     setEnabled(true);               //allow handling of keyboard and mouse events
+    setAutoBufferSwap(false);       //paintGL swaps once itself; a second swap would wait out another refresh
     
 	visChoice = 0;                  //which visualization is running. Start with basic waveform
 	myWave = NULL;
+	audioClock = NULL;              //no audio to follow until SetAudioClock is called
+	playing = false;
+	glReady = false;                //OpenGL is set up the first time the widget is shown or rendered offscreen
+	offscreen = NULL;
+	frameAdvance = 0;
+	frameRate = DEFAULT_FRAME_RATE; //frames drawn per second
+	frameTimerID = 0;               //no timer until a song is played
+	lastFrameTime = -1;             //no frame drawn yet
+	showProfile = false;            //the frame timing overlay is off until asked for
+	profileClock.start();
+
+	precomputeSpectra = true;
+
+	visualizations.Add(new BasicWave());            //numbered in the order added; see Visualizations.h
+	visualizations.Add(new WavyOceanyTypeThing());
+	visualizations.Add(new CamelParade());
+	visualizations.Add(new Blob());
+	visualizations.Add(new BlobPlusWave());
+	visualizations.Add(new Carpet3D());
+	visualizations.Add(new Surface3D());
+	visualizations.Add(new NoteSpectrum());
+
+	frame.wave = NULL;                              //no song yet
+	frame.batch = &batch;                           //visualizations draw with the widget's batch and shader
+	frame.waveShader = &waveShader;
+}
+
+GLWidget::~GLWidget()
+// POST: The visualizations (and any spectra they are still precomputing) and any offscreen framebuffer
+//       have been freed.
+{
+	EndOffscreen();
 }
 
 void GLWidget::playNewSong(Wave* song)
 // PRE:  song is initialized
 // POST: GLWidget is set up to play song. numSamples is reset to allow for 0.005 seconds of data.
 //         sampleNumber and lastSampleNumber are reset to start of song values, 0 and -1, respectively.
-//         myTimer is started to allow visualization to synchronize with playback. Qt is set up so
-//         timerEvent acts as an idle function. 
+//         Drawing follows audioClock from here on, and timerEvent is called frameRate times per
+//         second to draw each frame.
 {
-	myWave = song;                                      
-	
-	numSamples = myWave->GetSampleRate()*256/44100;     //for each frame, use 256 samples of data
-														//corresponding to 0.005 seconds of audio
-	sampleNumber = 0;                                   //set up variables to track position in song from the start
-	lastSampleNumber = -1;                              //initially we don't have a previous sample
-    
-	myTimer.Start();                                    //start timer for position in song
-	startTimer(0);                                      //start Qt's timer with timeout of 0, allowing
-                                                        //  the timerEvent function to act as an idle function
+	LoadSong(song);
+	profiler.Reset(frameRate);                          //time this song's frames afresh,
+	lastFrameTime = -1;                                 //  not from the last frame of the song before
+	playing = true;                                     //take the position in song from audioClock
+	StartFrameTimer();                                  //wake up once per frame to draw; the event loop
+                                                        //  sleeps in between
+}
+
+bool GLWidget::BeginOffscreen(Wave* song, int width, int height)
+// PRE:  song is initialized, width > 0, height > 0, no song is playing in this widget
+// POST: FCTVAL == true iff the graphics driver can draw into a framebuffer object. If so, frames of song
+//       can now be drawn width x height pixels in size with RenderFrame, whether or not the widget is
+//       shown. Spectra are not precomputed, so the DFT of every frame is taken as it is drawn and is
+//       the same every run.
+{
+    makeCurrent();
+    if (!glReady)                                           //never shown, so OpenGL has not been set up yet
+        glInit();
+
+    if (!QGLFramebufferObject::hasOpenGLFramebufferObjects())
+        return false;
+
+    EndOffscreen();                                         //drop any framebuffer of a different size
+    offscreen = new QGLFramebufferObject(width, height);
+    precomputeSpectra = false;                              //no background thread racing the frames
+    LoadSong(song);
+    SetVisualization(visChoice);                            //start every visualization from its initial view
+    return true;
+}
+
+void GLWidget::DrawOffscreen(int vis, long sample)
+// PRE:  BeginOffscreen succeeded, 0 <= vis < GetNumVisualizations(),
+//       0 <= sample and sample + 0.005 seconds of audio < length of song
+// POST: Visualization vis of the frame of song starting at sample sample has been drawn into the
+//       offscreen framebuffer, which is left bound (and this widget's context current) so the caller
+//       can read the pixels back with glReadPixels. Visualizations that move over time (the 3D
+//       carpet's rotation) carry on from the last frame drawn.
+{
+    makeCurrent();
+    offscreen->bind();
+    glViewport(0, 0, offscreen->width(), offscreen->height());
+
+    if (vis != visChoice)                                   //switching resets the view; staying keeps it moving
+        SetVisualization(vis);
+
+    sampleNumber = sample;
+    frameAdvance = lastSampleNumber < 0 ? 0 : sampleNumber-lastSampleNumber;
+    lastSampleNumber = sampleNumber;
+
+    DrawFrame(false);                                       //rendered frames are not played, so not profiled
+}
+
+QImage GLWidget::RenderFrame(int vis, long sample)
+// PRE:  As for DrawOffscreen
+// POST: FCTVAL == the frame drawn by DrawOffscreen(vis, sample)
+{
+    DrawOffscreen(vis, sample);
+    offscreen->release();
+    return offscreen->toImage();
+}
+
+void GLWidget::EndOffscreen()
+// POST: The offscreen framebuffer is freed, and the widget no longer has a song.
+{
+    if (offscreen)
+    {
+        makeCurrent();
+        delete offscreen;
+        offscreen = NULL;
+        myWave = NULL;
+        glViewport(0, 0, width(), height());                //back to drawing the window
+    }
 }
 
-void GLWidget::pauseSong()
-// POST: Widget is paused on the current frame
+const FrameProfiler& GLWidget::GetProfiler() const
+// POST: FCTVAL == the timings of the frames drawn recently
 {
-	myTimer.Pause();	//stop the passage of time
+    return profiler;
 }
 
 void GLWidget::resumeSong()
-// POST: If the widget is paused, resumes the widget. Otherwise, starts the widget.
+// POST: If the widget was stopped, it follows audioClock again. While the audio is paused, audioClock
+//       holds still, so the widget stays on the current frame without being told. The next frame
+//       drawn counts no frames dropped during the pause.
 {
-	if (myTimer.Started())		//if we're paused,
-		myTimer.UnPause();		//resume the widget
-	else
-	{
-		myTimer.Start();		//otherwise, start playing the widget
-	}
+	playing = true;
+	lastFrameTime = -1;       //the pause is not a frame interval
 }
 
 void GLWidget::stopSong()
-// POST: Halts widget, stopping the timer and bringing us back to the first frame.
+// POST: Halts widget, bringing us back to the first frame until resumeSong or playNewSong is called.
 {
-	myTimer.Stop();			  //stop the timer,
+	playing = false;		  //stop following the clock,
 	sampleNumber = 0;		  //reset to first sample
 	lastSampleNumber = -1;	  //there is no last sample
+	update();				  //show the first frame
 }
 
 void GLWidget::IncreaseRed()
@@ -91,27 +184,80 @@ void GLWidget::IncreaseBlue()
 void GLWidget::NextVisualization()
 // POST: visualization being displayed is advanced to the next option
 {
-    visChoice = visChoice >= LAST_VIS_CHOICE  ? 0         //If on last visualization, loop back to basic
-              : visChoice+1;                              //Otherwise, use next
-    SetVisualization(visChoice);                          //Change the display function
+    SetVisualization(visChoice >= GetNumVisualizations()-1  ? 0    //If on last visualization, loop back to basic
+                     : visChoice+1);                               //Otherwise, use next
 }
 
 void GLWidget::LastVisualization()
 // POST: visualization being displayed is moved to the previous option
 {
-    visChoice = visChoice == 0  ? LAST_VIS_CHOICE         //If on last visualization, loop back to basic
-              : visChoice-1;                              //Otherwise, use next
-    SetVisualization(visChoice);                          //Change the display function
+    SetVisualization(visChoice == 0  ? GetNumVisualizations()-1    //If on first visualization, loop back to last
+                     : visChoice-1, -1);                           //Otherwise, use previous
+}
+
+int GLWidget::GetNumVisualizations() const
+// POST: FCTVAL == the number of visualizations, numbered from 0 in the order listed in Visualizations.h
+{
+    return visualizations.GetCount();
+}
+
+const char* GLWidget::GetVisualizationName(int vis) const
+// PRE:  0 <= vis < GetNumVisualizations()
+// POST: FCTVAL == the name of visualization vis, as shown to the user
+{
+    return visualizations[vis].GetName();
+}
+
+void GLWidget::SetAudioClock(const AudioClock* clock)
+// PRE:  clock outlives this widget
+// POST: The frame drawn is chosen from the playback position clock reports.
+{
+    audioClock = clock;
+}
+
+void GLWidget::SetFrameRate(int fps)
+// PRE:  fps > 0
+// POST: Frames are drawn fps times per second, or as often as the display refreshes if that is less.
+{
+    frameRate = fps;
+    profiler.Reset(fps);                                  //frames count as dropped against the new rate
+    lastFrameTime = -1;
+    if (frameTimerID)                                     //only restart the timer if a song is playing
+        StartFrameTimer();
+}
+
+void GLWidget::SetProfileVisible(bool visible)
+// POST: If visible, every frame shown in the window is overlaid with a summary of how long recent
+//       frames took to draw, how many were dropped and how far they lagged the audio.
+{
+    showProfile = visible;
+    update();
+}
+
+void GLWidget::SetSpectralCache(bool enabled)
+// POST: If enabled, the spectrum of every frame of the current and future songs is computed in the
+//       background as soon as the song is loaded, so the DFT visualization only has to look it up.
+//       Otherwise, any precomputed spectra are discarded and the DFT is taken as each frame is drawn.
+{
+    precomputeSpectra = enabled;
+    if (myWave)                                           //build (or throw away) spectra for the current song
+        LoadVisualizations();
 }
 
 void GLWidget::initializeGL()
 // POST: OpenGL window is created to hold our visualization. Window dimensions are given by global constants
 // 		 FRAME_WIDTH and FRAME_HEIGHT. Window has a black background.
 {
-    SetVisualization(visChoice);		                    //Set function pointers for animation
+    SetVisualization(visChoice);		                    //Start the visualization from its initial view
      
 	glClearColor(0.0, 0.0, 0.0, 0.0);                       //Set window background color to black
     
+    batch.Create();                                         //Set up the vertex buffer each frame is drawn from
+    waveShader.Create();                                    //Compile the waveform shaders, if the card can run them
+    for (int vis=0; vis < visualizations.GetCount(); vis++) //Set up the buffers each visualization draws from
+        visualizations[vis].Create();
+    glReady = true;
+
     glEnable(GL_BLEND);										//Enable use of alpha color information (for transparency)
     
     if(isApple)		     									//The Apple os handles transparency differently than unix,
@@ -132,57 +278,23 @@ void GLWidget::paintGL()
 //       graphical representation of 256 samples of the audio representing 0.005 seconds of audio data from
 //       the time this method is called
 {
-    glClear(GL_COLOR_BUFFER_BIT);                                    //actually clear the drawing window
-    
-    if (myWave)
-	{
-        switch(visChoice)                                            //Reset display func for given vis choice
-        {
-            case 0:
-                GLDisplayBasicWave();
-                break;
-            case 1:
-                GLDisplayWavyOceanyTypeThing();
-                break;
-            case 2:
-                GLDisplayCamelParade();
-                break;
-            case 3:
-                GLDisplayBlob();
-                break;
-            case 4:
-                GLDisplayBlobPlusWave();
-                break;
-            case 5:
-                GLDisplay3DCarpet();
-                break;
-            case 6:
-                GLDisplay3DSurface();
-                break;
-            case 7:
-            	GLDisplayDFT();
-            	break;
-            default:
-                GLDisplayBasicWave();
-        }
-        
-		swapBuffers();
-	}                                                
+    DrawFrame(playing);                                              //a frame drawn while stopped is not one played
+    if (showProfile)
+        DrawProfile();
+	swapBuffers();                                                   //show the frame at the next display refresh
 }
 
 void GLWidget::timerEvent(QTimerEvent *)
-// POST: sampleNumber is reset to draw the current frame based upon the time that has elapsed since
-//       the drawing started. If the audio is not over, lastSampleNumber is reset to this value of
+// POST: sampleNumber is reset to draw the current frame based upon the playback position reported
+//       by audioClock. If the audio is not over and time has moved on, frameAdvance is set to
+//       the samples played since the last frame (0 after a seek), lastSampleNumber is reset to
 //       sampleNumber to be used in the next call and the animation is refereshed.
 {
-	if (myWave)                                                                     //draw only when we have a song 
+	if (myWave && audioClock && playing)                                            //draw only when we have a song 
 	{
-		sampleNumber = myWave->GetSampleRate()*(myTimer.GetMilliSeconds()/1000.0);  //sample rate in samples/second
-																					//  mult. by current time in seconds
+		sampleNumber = myWave->GetSampleRate()*audioClock->GetSeconds();            //sample rate in samples/second
+																					//  mult. by seconds the device has played
 																					//  gives which sample to display
-		sampleNumber -= (sampleNumber % (myWave->GetSampleRate()/FPS));             //adjust sample number to get the
-			                                                                        //  nearest sample we'll actually
-			                                                                        //  draw
 		if (sampleNumber+numSamples >= myWave->GetSamplesPerChannel())              //when we've passed the end of the song
 		{                                                                           //  stop drawing.
 			stopSong();                                                             //stop drawing here.
@@ -190,445 +302,201 @@ void GLWidget::timerEvent(QTimerEvent *)
 			return;
 		}
 
+		profiler.CountTick(sampleNumber != lastSampleNumber);                       //count ticks that find nothing new
+
 		if (sampleNumber != lastSampleNumber)                                       //if we're not repeating a frame,
 		{                                                                           //  draw the next frame
-			emit timePassed(myTimer.GetMilliSeconds());                             //tell UI about time change for
+			emit timePassed(audioClock->GetMilliSeconds());                         //tell UI about time change for
                                                                                     //  updating slider
+			frameAdvance = lastSampleNumber < 0 ? 0                                 //how far the song moved since
+			             : sampleNumber-lastSampleNumber;                           //  the last frame
+			if (frameAdvance < 0 || frameAdvance > myWave->GetSampleRate())         //a seek, not a frame's worth of
+				frameAdvance = 0;                                                   //  playing
 			lastSampleNumber = sampleNumber;                                        //advance previous sample
 			update();                                                               //draw new frame of visualization
 		}
 	}
 }
 
-void GLWidget::SetVisualization(int vis)
-// PRE:  0 <= vis <= LAST_VIS_CHOICE
-// POST: Visualization running changed: 0: Basic Wave, 1: Wavy Oceany Type Thing, 2: Camel Parade, 3: Blob,
-//       4: Blob plus Wave, 5. 3D Carpet, 6. 3D Surface. When vis > LAST_VIS_CHOICE, Basic Wave is displayed
+void GLWidget::SetVisualization(int vis, int step)
+// PRE:  step is 1 or -1
+// POST: Visualization running changed to vis (see Visualizations.h), or if the current song lacks what it
+//       needs, to the next one in the direction of step that can show it. The new visualization starts
+//       over from its initial view. When vis >= GetNumVisualizations() or vis < 0, Basic Wave is displayed
 {
-    visChoice = vis;                                            //Reset display function class member
-    
-    if(visChoice > LAST_VIS_CHOICE || visChoice < 0)            //Use basic waveform when invalid choices are given
-    {
-        visChoice = 0;
-    }
-    
-    if(vis >= 0 && vis <= 4)                                    //Set viewing properties for 2D visualizations
+    if(vis >= GetNumVisualizations() || vis < 0)                //Use basic waveform when invalid choices are given
     {
-        glMatrixMode(GL_PROJECTION);                            //Set viewing window properties
-        glLoadIdentity();
-        gluOrtho2D(0.0, FRAME_WIDTH, 0.0, FRAME_HEIGHT);
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+        vis = 0;
     }
-    else if(vis >= 5 && vis <= 6)                               //Set viewing properties for 3D visualizations
-    {
-        glMatrixMode(GL_PROJECTION);                            //Set viewing window properties
-        glLoadIdentity();
-        glOrtho(-FRAME_WIDTH, FRAME_WIDTH, -FRAME_HEIGHT, FRAME_HEIGHT, 0, sqrt(2*pow(2*FRAME_WIDTH,2)+pow(2*FRAME_HEIGHT,2)));
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
-        gluLookAt(2*FRAME_WIDTH, 2*FRAME_HEIGHT, FRAME_WIDTH,
-                  0, 0, -FRAME_WIDTH,
-                  0, 1, 0);
-    }
-    
-}
 
-
-
-//==============================================================================
-// VISUALIZATION HELPER FUNCTIONS
-//------------------------------------------------------------------------------
-// Each of these methods helps one of the visualization functions below. 
-//==============================================================================
-
-double GLWidget::MaxAmplitude()                             //5. 3D Carpet [helper]                         
-//PRE: myWave initialized
-//POST: FCTVAL == the maximum amplitude of the wave in the current frame (from 0...1)
-{
-	double max = 0;                                         //holder for maximum amplitude
-    
-	for (int n = 0; n < myWave->GetNumChannels(); n++)      //loop through each channel
-	{
-		for (int i=0; i < numSamples; i++)                  //and each sample of each channel
-		{                                                   //(offset by the current frame's sample number)
-			if (fabs((*myWave)[n][sampleNumber+i]) > max)   //if the amplitude of the current sample is greater than the current max,
-				max = fabs((*myWave)[n][sampleNumber+i]);   //reset the max.
-		}
-	}
-	return max;
+    visChoice = visualizations.Pick(vis, step, myWave);         //Skip any that cannot show this song (mono songs
+                                                                //  have no second channel for the stereo ones)
+    visualizations[visChoice].Start();
 }
 
-double GLWidget::WaveHeight(int n, int i)                   //5. 3D Carpet [helper]
-//PRE: n < number of channels, i < number of samples per channel
-//POST: FCTVAL == the intended height of the wave at sample i of channel n used in GLDisplay3DCarpet
+void GLWidget::LoadSong(Wave* song)
+//PRE:  song is initialized
+//POST: myWave == song, numSamples is reset to allow for 0.005 seconds of data, sampleNumber and
+//      lastSampleNumber are reset to 0 and -1, and every visualization has been loaded with song. If the
+//      current visualization cannot show song, the next one that can is picked.
 {
-	int phaseShift = sampleNumber/(myWave->GetSampleRate()/FPS);		 //Used for scrolling. Is advanced by 1 every frame.
-	return (FRAME_HEIGHT/2*(1+(0.5+0.7*MaxAmplitude())*sin(2*M_PI*double(i)/numSamples+phaseShift)/2+(*myWave)[n][sampleNumber+i]));
+	myWave = song;                                      
+	
+	numSamples = myWave->GetSampleRate()*256/44100;     //for each frame, use 256 samples of data
+														//corresponding to 0.005 seconds of audio
+	sampleNumber = 0;                                   //set up variables to track position in song from the start
+	lastSampleNumber = -1;                              //initially we don't have a previous sample
+	frameAdvance = 0;
+
+	frame.wave = myWave;
+	frame.numSamples = numSamples;
+	LoadVisualizations();                               //let each visualization build its buffers for this song
+	if (!visualizations[visChoice].Supports(*myWave))   //e.g. a stereo visualization left on for a mono song
+		SetVisualization(visChoice);
 }
 
-void GLWidget::SurfaceVertex(int i, int j)                  //6. 3D Surface [helper]
-//PRE: i, j < samples per channel
-//POST: FCTVAL the intended height of the wave at coordinate (i,j) as used in GLDisplay3DSurface
+void GLWidget::LoadVisualizations()
+//PRE:  myWave initialized
+//POST: Every visualization has been loaded with myWave, precomputing it in the background if
+//      precomputeSpectra is set.
 {
- 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
-    //  the horizontal spacing between samples.
-    
-    glVertex3i(i*trapWidth, FRAME_HEIGHT*(0.2+(*myWave)[0][sampleNumber+i]+(*myWave)[1][sampleNumber+j]),-j*trapWidth);
+	for (int vis=0; vis < visualizations.GetCount(); vis++)
+		visualizations[vis].Load(*myWave, numSamples, precomputeSpectra);
 }
 
-
-
-//==============================================================================
-// VISUALIZATION FUNCTIONS
-//------------------------------------------------------------------------------
-// Each of these methods is called from paintGL based upon visChoice. 
-//==============================================================================
-
-void GLWidget::GLDisplayBasicWave()                                     //0. visualization of basic waveform
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+void GLWidget::DrawFrame(bool profile)
+//POST: The window or framebuffer being drawn to has been cleared and, if there is a song, the frame
+//      of visualization visChoice starting at sampleNumber has been analyzed and drawn into it, under
+//      the 2D or 3D view it asks for. If profile, its timings have been recorded in profiler.
 {
-    glLineWidth(3.0);                                                   //set line width to 3 pixels
-    glColor3f(red, green, blue);
+    glClear(GL_COLOR_BUFFER_BIT);                                    //actually clear the drawing window
     
-    for (int j=0; j<myWave->GetNumChannels(); j++)                      //go through each channel of audio
-    {
-        glBegin(GL_LINE_STRIP);                                         //make it so points are connected
-        for (int i=1; i<numSamples; i++)                                //draw each point of the current sample
-            glVertex2i(i*FRAME_WIDTH/numSamples,                        //x coord. moves us across screen
-                       FRAME_HEIGHT/myWave->GetNumChannels()            //y coord. is based upon the height
-                       *(j+1/2.0+(*myWave)[j][sampleNumber+i]/2));      //  of the sound wave at that instant
-        glEnd();
-    }
+    if (myWave)
+	{
+        FrameTiming timing;                                          //how long this frame takes, for the profiler
+        double start = profileClock.nsecsElapsed()/1e6;              //ms when drawing began
+
+        Visualization& vis = visualizations[visChoice];              //picked ahead of time, so it can show myWave
+
+        batch.Clear();                                               //start collecting this frame's vertices
+        AnalyzeFrame();                                              //measure this frame once for every visualization
+        SetView(vis.GetFlags() & THREE_D);
+        vis.Analyze(frame);
+        vis.Render(frame);
+
+        timing.compute = profileClock.nsecsElapsed()/1e6;            //ms when the batch was ready; shader
+                                                                     //  and mesh draws count as computing
+        batch.Draw();                                                //upload and draw them all at once
+
+        timing.time = profileClock.nsecsElapsed()/1e6;
+        timing.submit = timing.time - timing.compute;
+        timing.compute -= start;
+        timing.interval = lastFrameTime < 0 ? -1 : timing.time - lastFrameTime;
+        timing.drift = playing && audioClock                         //how far the audio has moved on
+                     ? audioClock->GetSeconds()*1000 - sampleNumber*1000.0/myWave->GetSampleRate() : 0;
+        timing.visualization = visChoice;
+        if (profile)
+        {
+            lastFrameTime = timing.time;
+            profiler.Record(timing);
+        }
+	}                                                
 }
 
-
-void GLWidget:: GLDisplayWavyOceanyTypeThing()                        //1. "Wavy Oceany Type Thing" Visualization
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+void GLWidget::DrawProfile()
+//POST: The profiler's summary of recent frames has been written over the top left of the window.
 {
- 	int phaseShift = sampleNumber/(myWave->GetSampleRate()/FPS);     //Used for scrolling. Is advanced by 1 every frame.
- 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
-                                                                     //  the horizontal spacing between samples.
+    vector<string> lines = profiler.Summary();
+    QFont font("Monospace", 9);                                      //fixed width keeps the columns still
 
-    glLineWidth(2.0);                                                //set line width to 3 pixels
-    
-    // We wish to fill the area underneath the waveform we draw. However, OpenGL will not fill concave polygons, thus we
-    // draw the outline of the polygon defined by our waveform and the bottom of the screen and fill it in separately. To
-    // fill it in, we subdivide our polygon into numSamples-1 trapezoids and fill those with a lighter shade of blue. We
-    // draw the fill first so it doesn't hide the outline. See the outline code for explanation of the waveform.
-    
-    glColor3f(red/2, green/2, blue/2);                                      //set fill color lighter than line color
-    
-    for (int i=0; i < numSamples-1; i++)                                    //divide area under waveform into trapezoids for filling
-    {                                                                       //one fewer trapezoids than samples as traps. use 2 samples
-        glBegin(GL_POLYGON);
-        glVertex2i(i*trapWidth, 0);                                                                         //bottom left
-        glVertex2i(i*trapWidth, FRAME_HEIGHT/2*(1+sin(2*M_PI*double(i)/numSamples+phaseShift)/2
-                                                +(*myWave)[0][sampleNumber+i]));                            //top left
-        glVertex2i((i+1)*trapWidth, FRAME_HEIGHT/2*(1+sin(2*M_PI*double(i+1)/numSamples+phaseShift)/2
-                                                     +(*myWave)[0][sampleNumber+i+1]));                     //top right -- next sample
-        glVertex2i((i+1)*trapWidth, 0);                                                                     //bottom right -- next sample
-        glEnd();
-    }
-    
-    glColor3f(red, green, blue);
-    glBegin(GL_LINE_STRIP);                                 	 			//make it so points form connected line
-    for (int i=0; i<numSamples; i++)                        	 			//draw each point of the current sample
-        glVertex2i(i*trapWidth,                  							//x coord. moves us across screen
-                   FRAME_HEIGHT/2                                           //wrap y coord. around sine wave half as tall as screen
-                   *(1+sin(2*M_PI*double(i)/numSamples+phaseShift)/2	    //we have one period across screen
-                     +(*myWave)[0][sampleNumber+i])); 	     				//add height of sound wave at each sample
-    
-    glVertex2i(FRAME_WIDTH, 0);                                                     //Draw down to bottom-right corner
-    glVertex2i(0,0);                                                                //Draw left to bottom-left corner
-    glVertex2i(0,FRAME_HEIGHT/2*(1+sin(phaseShift)/2+(*myWave)[0][sampleNumber]));  //Draw up to first sample
-    glEnd();
+    font.setStyleHint(QFont::TypeWriter);
+    glColor4f(1.0, 1.0, 1.0, 1.0);
+    for (unsigned int i=0; i < lines.size(); i++)
+        renderText(8, 16 + 14*i, QString::fromStdString(lines[i]), font);
 }
 
-void GLWidget::GLDisplayCamelParade()                                         //2. "Camel Parade" visualization
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+void GLWidget::SetView(bool threeD)
+//POST: The projection and modelview matrices are set up for 3D visualizations if threeD, otherwise
+//      for 2D ones, which are drawn on a FRAME_WIDTH x FRAME_HEIGHT window.
 {
- 	int phaseShift = sampleNumber/((*myWave).GetSampleRate()/FPS);   //Used for scrolling. Is advanced by 1 every frame.
- 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
-                                                                     //  the horizontal spacing between samples.
-    
-    glLineWidth(2.0);                                                //set line width to 3 pixels
-    
-    // We wish to fill the area between two waveforms we draw. However, OpenGL will not fill concave polygons, thus we
-    // draw the outline of the polygon defined by our waveform and the bottom of the screen and fill it in separately. To
-    // fill it in, we subdivide our polygon into numSamples-1 trapezoids and fill those with a lighter shade of blue. We
-    // draw the fill first so it doesn't hide the outline. See the outline code for explanation of the waveform.
-    
-    // Fill in area between waveforms.
-    glColor3f(red/2, green/2, blue/2);                              //set fill color lighter than line color
-    
-    if (myWave->GetNumChannels() < 2)                               //This visualization does not handle mono wav files,
+    if(!threeD)                                                 //Set viewing properties for 2D visualizations
     {
-        SetVisualization(++visChoice);                              //skip to next visualization
-        return;
-    }
-    
-    for (int i=0; i < numSamples-1; i++)                                    //divide area under waveform into trapezoids for filling
-    {                                                                       //one fewer trapezoids than samples as traps. use 2 samples
-        glBegin(GL_POLYGON);
-        glVertex2i(i*trapWidth, FRAME_HEIGHT/2*(1-sin(2*M_PI*double(i)/numSamples+phaseShift)/2             //bottom left, channel 1
-                                                -(*myWave)[1][sampleNumber+numSamples-1-i]));
-        glVertex2i(i*trapWidth, FRAME_HEIGHT/2*(1+sin(2*M_PI*double(i)/numSamples+phaseShift)/2             //top left, channel 0
-                                                +(*myWave)[0][sampleNumber+i]));
-        glVertex2i((i+1)*trapWidth, FRAME_HEIGHT/2*(1+sin(2*M_PI*double(i+1)/numSamples+phaseShift)/2       //top right, channel 0,
-                                                    +(*myWave)[0][sampleNumber+i+1]));                                         //  next sample
-        glVertex2i((i+1)*trapWidth, FRAME_HEIGHT/2*(1-sin(2*M_PI*double((i+1))/numSamples+phaseShift)/2     //bottom right, channel 1,
-                                                    -(*myWave)[1][sampleNumber+numSamples-2-i]));                              //  next sample
-        glEnd();
+        glMatrixMode(GL_PROJECTION);                            //Set viewing window properties
+        glLoadIdentity();
+        gluOrtho2D(0.0, FRAME_WIDTH, 0.0, FRAME_HEIGHT);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
     }
-    
-    // Draw waveform for left channel at the top
-    glColor3f(red, green, blue);
-    glBegin(GL_LINE_STRIP);                                                     //make it so points form a connected line
-    for (int i=0; i<numSamples; i++)                                            //draw each point of the current sample
-        glVertex2i(i*trapWidth,                                                 //x coord. moves us across screen
-                   FRAME_HEIGHT/2                                               //wrap y coord. around sine wave half as tall as screen
-                   *(1+sin(2*M_PI*double(i)/numSamples+phaseShift)/2	        //we have one period across screen
-                     +(*myWave)[0][sampleNumber+i])); 			 				//y coord. is based upon the height of sound wave
-                                                                                //add height of sound wave at each sample
-    glEnd();
-    
-    // Draw waveform for right channel at the bottom, reversed
-    glBegin(GL_LINE_STRIP);                                                     //make it so points form a connected line
-    for (int i=0; i < numSamples; i++)
+    else                                                        //Set viewing properties for 3D visualizations
     {
-        glVertex2i(i*trapWidth,                                                 //match x coordinate with left channel
-                   FRAME_HEIGHT/2
-                   *(1-sin(2*M_PI*double(i)/numSamples+phaseShift)/2
-                     -(*myWave)[1][sampleNumber+numSamples-1-i]));              //use y-coordinate of sample measured from other end
+        glMatrixMode(GL_PROJECTION);                            //Set viewing window properties
+        glLoadIdentity();
+        glOrtho(-FRAME_WIDTH, FRAME_WIDTH, -FRAME_HEIGHT, FRAME_HEIGHT, 0, sqrt(2*pow(2*FRAME_WIDTH,2)+pow(2*FRAME_HEIGHT,2)));
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        gluLookAt(2*FRAME_WIDTH, 2*FRAME_HEIGHT, FRAME_WIDTH,
+                  0, 0, -FRAME_WIDTH,
+                  0, 1, 0);
     }
-    glEnd();
 }
 
-
-void GLWidget::GLDisplayBlob()                                                //3. "blob" from AS3 visualizer
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+QGLFormat GLWidget::SyncedFormat()
+//POST: FCTVAL == a double buffered OpenGL format whose buffer swaps wait for the display's next refresh
 {
-    double radius = FRAME_HEIGHT < FRAME_WIDTH                        //radius of circle about which wave is drawn
-                  ? FRAME_HEIGHT/4                                    //  set based upon smaller screen dimension
-                  : FRAME_WIDTH/4;
-    
-    int x;                                                           //x coordinate of current point, in pixels
-    int y;                                                           //y coordinate of current point, in pixels
-    double progress;                                                 //fraction of progress made around the circle
-    double curValue;                                                 //current amplitude of sound wave
-    
-    glLineWidth(3.0);                                                //set line width to 3 pixels
-    glColor3f(0.0,0x88/0xff,1.0);                                    //set line color to blue
-    
-    glBegin(GL_POLYGON);                                             //connect points and fill polygon
-    
-    for (int j=0; j<myWave->GetNumChannels(); j++)                   //go through each channel of audio
-    {
-        for (int i=0; i<numSamples; i++)                             //draw each point of the current sample
-        {
-            progress = double(i + j*numSamples)                       //account for previous channels plus how far into this one
-                     / (numSamples*myWave->GetNumChannels()-1);       //we have numSamples points to draw in each channel
-            
-            glColor3f(0, .2+.8*progress, .2+.8*progress);
-            
-            if(j%2 == 1)                                                //odd channels drawn in forward order
-                curValue = (*myWave)[j][sampleNumber+i];
-            else                                                        //even channels drawn in reverse order
-                curValue = (*myWave)[j][sampleNumber+numSamples-i];
-            
-            x = FRAME_WIDTH/2 + radius*cos(360*progress*M_PI/180)       //location of this point if we were drawing a circle
-              * (1-curValue);                                           //offset radius based upon current data
-            y = FRAME_HEIGHT/2 -radius*sin(360*progress*M_PI/180)       //analogous to x but use sin for y
-              * (1-curValue);
-            
-            glVertex2i(x, y);
-        }
-    }
-    
-    glVertex2i(FRAME_WIDTH/2 + radius*(1-(*myWave)[0][0]),
-               FRAME_HEIGHT/2);                                         // reconnect to first point
-    
-    glEnd();
-}
+    QGLFormat format;
 
+    format.setDoubleBuffer(true);
+    format.setSwapInterval(1);                              //vsync: never draw faster than the display shows frames
+    return format;
+}
 
-void GLWidget::GLDisplayBlobPlusWave()                                  //4. "blob" from AS3 visualizer + Basic Waveform
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+void GLWidget::StartFrameTimer()
+//POST: Any old frame timer is stopped, and timerEvent is called every 1/frameRate seconds from now on.
 {
-    GLDisplayBasicWave();
-    GLDisplayBlob();     
+    if (frameTimerID)
+        killTimer(frameTimerID);
+    frameTimerID = startTimer(1000/frameRate, Qt::PreciseTimer);
 }
 
+//==============================================================================
+// VISUALIZATION HELPER FUNCTIONS
+//------------------------------------------------------------------------------
+// These methods work out the FrameInfo handed to the visualizations, which
+// live in Visualizations.cpp.
+//==============================================================================
 
-
-void GLWidget::GLDisplay3DCarpet()                                     //5. 3D Carpet
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+double GLWidget::PhaseShift()                              //0.-2., 5. Scrolling waveforms [helper]
+//PRE:  myWave initialized
+//POST: FCTVAL == how far the sine waves have scrolled at sampleNumber, in radians (from 0...2*pi). Advances
+//      by 1 every 1/SCROLL_RATE seconds of audio, smoothly however often frames are drawn.
 {
-    
-	glTranslatef(FRAME_WIDTH/2, 0, -FRAME_WIDTH*1.0*(myWave->GetNumChannels()-1)/2.0);	//Translate the center of the "floor" from the origin
-	glRotatef(60.0*MaxAmplitude()/FPS, 0.0, 1.0, 0.0);									//Rotate about the y axis
-	glTranslatef(-FRAME_WIDTH/2, 0, FRAME_WIDTH*1.0*(myWave->GetNumChannels()-1)/2.0);	//Translate the center of the "floor" to the origin
-                                                                                        //(note that matrix transformations are given in reverse)
-    
- 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
-                                                                     //  the horizontal spacing between samples.
-    
-    glLineWidth(2.0);                                                //set line width to 3 pixels
-    
-    if (myWave->GetNumChannels() < 2)                               //This visualization does not handle mono wav files,
-    {
-        SetVisualization(++visChoice);                              //skip to next visualization
-        return;
-    }
-    
-    // Okay, really..
-    // We wish to fill the area underneath the waveform we draw. However, OpenGL will not fill concave polygons, thus we
-    // draw the outline of the polygon defined by our waveform and the bottom of the screen and fill it in separately. To
-    // fill it in, we subdivide our polygon into numSamples-1 trapezoids and fill those with a lighter shade of blue. We
-    // draw the fill first so it doesn't hide the outline. See the outline code for explanation of the waveform.
-    
-    //glColor3f(0.0, (0.5*0x88)/0xff, (0.5*0xFF)/0xFF);                       //set fill color
-    
-    /*for (int n=0; n < myWave->GetNumChannels(); n++)
-     {
-     glColor4f(red, green, blue, 0.5);                                      //set fill color lighter than line color
-     for (int i=0; i < numSamples-1; i++)                                    //divide area under waveform into trapezoids for filling
-     {                                                                       //one fewer trapezoids than samples as traps. use 2 samples
-         glBegin(GL_POLYGON);
-         glVertex3i(i*trapWidth, 0, -FRAME_WIDTH*n);                                                                         //bottom left
-         glVertex3i(i*trapWidth, WaveHeight(n, i), -FRAME_WIDTH*n);                                               //top left
-         glVertex3i((i+1)*trapWidth, WaveHeight(n,i), -FRAME_WIDTH*n);                                         //top right -- next sample
-         glVertex3i((i+1)*trapWidth, 0, -FRAME_WIDTH*n);                                                                     //bottom right -- next sample
-         glEnd();
-     }
-     
-     glColor3f(red, green, blue);
-     //glColor3f(0.0,double(0x88)/0xff,1.0);                                 //set line color to blue
-     glBegin(GL_LINE_STRIP);                                 	 			//make it so points form connected line
-     for (int i=0; i<numSamples; i++)                        	 			//draw each point of the current sample
-     glVertex3i(i*trapWidth, WaveHeight(n, i), -FRAME_WIDTH*n);   					//x coord. moves us across screen
-     //wrap y coord. around sine wave half as tall as screen
-     //we have one period across screen
-     //add height of sound wave at each sample
-     
-     glVertex3i(FRAME_WIDTH, 0, -FRAME_WIDTH*n);										//Draw down to bottom-right corner
-     glVertex3i(0,0, -3*n);													//Draw left to bottom-left corner
-     glVertex3i(0, WaveHeight(n, 0), -FRAME_WIDTH*n);                                  //Draw up to first sample
-     glEnd();
-     }*/
-    glColor4f(red, green, blue, 0.5);                                      //set fill color lighter than line color
-    
-    // draw a surface by directly connecting each sample of the nth channel to the corresponding sample on the (n+1)th
-    // channel. We do this by drawing a "rectangle" (comprised of two triangles) between consecutive samples on each channel
-    for (int n=0; n < myWave->GetNumChannels()-1; n++)			//loop through each channel that has a next channel...
-    {
-        for (int i=0; i < numSamples-1; i++)					//...and every sample of that channel...
-        {
-            glBegin(GL_POLYGON);												//and draw two triangles connecting this sample,
-            glVertex3i(i*trapWidth, WaveHeight(n, i), -FRAME_WIDTH*n);			//the next sample, and both corresponding samples
-            glVertex3i(i*trapWidth, WaveHeight(n+1, i), -FRAME_WIDTH*(n+1));    //on the next channel.
-            glVertex3i((i+1)*trapWidth, WaveHeight(n, i+1), -FRAME_WIDTH*n);
-            glEnd();
-            
-            glBegin(GL_POLYGON);
-            glVertex3i(i*trapWidth, WaveHeight(n+1, i), -FRAME_WIDTH*(n+1));
-            glVertex3i((i+1)*trapWidth, WaveHeight(n, i+1), -FRAME_WIDTH*n);
-            glVertex3i((i+1)*trapWidth, WaveHeight(n+1, i+1), -FRAME_WIDTH*(n+1));
-            glEnd();
-        }
-    }
+    return fmod(double(sampleNumber)*SCROLL_RATE/myWave->GetSampleRate(), 2*M_PI);
 }
 
-void GLWidget::GLDisplay3DSurface()                                 //6. 3D Surface
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
+void GLWidget::AnalyzeFrame()                                //frame analysis, shared by all visualizations
+//PRE: myWave initialized
+//POST: frame describes the frame starting at sampleNumber: frame.maxAmplitude == the maximum amplitude
+//      of the wave in it across all channels (from 0...1), and its position, scroll phase and colors are those
+//      of the widget
 {
-    glLineWidth(2.0);                                                //set line width to 3 pixels
-    
-    if (myWave->GetNumChannels() < 2)                               //This visualization does not handle mono wav files,
-    {
-        SetVisualization(++visChoice);                              //skip to next visualization
-        return;
-    }
-    
-    glColor4f(red, green, blue, 0.1);                                      //set fill color lighter than line color
-    
-    //draw a "surface" whose height is a function of the position on an imaginary FRAME_WIDTH*FRAME_WIDTH grid (with
-    // numSamples tickmarks) positioned in the positive-x, negative-y quadrant. The height at any point on this grid
-    // corresponds to the sum of the left and right channel sample information.
-    for (int i=0; i < numSamples-1; i++)		//loop through every (i,j) point on our imaginary grid...
-    {
-        for (int j=0; j < numSamples-1; j++)
-        {
-            glBegin(GL_POLYGON);				//...so we may draw two triangles in each square of the grid
-            SurfaceVertex(i,j);					// (because we need convex polygons) that correspond to our
-            SurfaceVertex(i,j+1);				// sound wave's information.
-            SurfaceVertex(i+1,j+1);
-            glEnd();
-            
-            glBegin(GL_POLYGON);
-            SurfaceVertex(i,j);
-            SurfaceVertex(i+1,j);
-            SurfaceVertex(i+1,j+1);
-            glEnd();
-        }
-    }
-}
-
-void GLWidget::GLDisplayDFT()                                     //7. visualization of the DFT of the waveform
-// POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-//       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-//       0.005 seconds of audio data from the time this method is called
-{
-    glLineWidth(3.0);                                                   //set line width to 3 pixels
-    glColor3f(red, green, blue);
-    vector<complex<double> > input;
-    vector<complex<double> > output;
-    vector<double>	frequencies;
-    double max = 0;
-    
-    if (log(numSamples)/log(2.0) - floor(log(numSamples)/log(2)) >= 0.0001)
-    {
-    	visChoice++;
-		SetVisualization(visChoice);
-		return;
-	}
+	double max = 0;                                         //holder for maximum amplitude
+	double sample;                                          //current sample
     
-    for (int i=0; i < numSamples; i++)
-    	input.push_back(complex<double>((*myWave)[0][sampleNumber+/*myWave->GetSampleRate()/11025**/i], 0.0));
-    	
-	output = Utility::FFT(input);
-	
-	for (int i=0; i < numSamples/2; i++)
+	for (int n = 0; n < myWave->GetNumChannels(); n++)      //loop through each channel
 	{
-		frequencies.push_back(sqrt(pow(output[i].real(),2.0)+pow(output[i].imag(),2.0)));
-		if (frequencies[i] > max)
-			max = frequencies[i];
+		for (int i=0; i < numSamples; i++)                  //and each sample of each channel
+		{                                                   //(offset by the current frame's sample number)
+			sample = (*myWave)[n][sampleNumber+i];
+			if (fabs(sample) > max)                         //if the amplitude of the current sample is greater than the current max,
+				max = fabs(sample);                         //reset the max.
+		}
 	}
 	
-	for (int i=0; i < numSamples/2; i++)
-		frequencies[i] /= max;     
-                                          
-    for (int i=1; i<numSamples/2; i++)
-    {
-    	glBegin(GL_LINE_STRIP);                      
-        glVertex2i(i*FRAME_WIDTH*2/numSamples, 0);
-        glVertex2i(i*FRAME_WIDTH*2/numSamples, frequencies[i]*FRAME_HEIGHT);                           
-    	glEnd();
-    }
+	frame.maxAmplitude = max;
+	frame.sampleNumber = sampleNumber;
+	frame.advance = frameAdvance;
+	frame.phaseShift = PhaseShift();
+	frame.red = red;
+	frame.green = green;
+	frame.blue = blue;
 }
-
@@ -5,30 +5,30 @@
 
 #include <QtOpenGL>
 #include <QObject>
+#include <QElapsedTimer>
 #include <iostream>
 #include <math.h>
 #include <string.h>
 #include <string>
 #include "Wave/Wave.h"
-#include "Wave/Timer.h"
+#include "AudioClock.h"
+#include "VertexBatch.h"
+#include "WaveShader.h"
+#include "Visualizations.h"
+#include "FrameProfiler.h"
 #include <iomanip>
 using namespace std;
 
-#ifdef __APPLE__                                  //SDL settings different on Apple
-#include <SDL_mixer/SDL_mixer.h>
+#ifdef __APPLE__                                  //screen and blending settings different on Apple
 #define FULL_SCREEN_STRING "1440x900:24@12"
 #define isApple true
 #else
-#include <SDL/SDL_mixer.h>
 #define FULL_SCREEN_STRING "1360x768:24@12"
 #define isApple false
 #endif
 
 
-const GLint FRAME_WIDTH = 720;           //width of display window in pixels (but it can be resized easily)
-const GLint FRAME_HEIGHT = 450;          //height of display window in pixels
-const int FPS = 12;						 //how many frames of visualization to use per second
-const int LAST_VIS_CHOICE = 7;           //index of the last visualization ID we have defined
+const int DEFAULT_FRAME_RATE = 60;        //frames of visualization drawn per second unless SetFrameRate changes it
 
  
 class GLWidget : public QGLWidget
@@ -39,23 +39,51 @@ public:
     GLWidget(QWidget* parent);
     // POST: GLWidget constructed, with line color set to medium blue, visualization set to basic 
     //       waveform, and with widget able to handle keyboard and mouse events.
+
+    ~GLWidget();
+    // POST: The visualizations (and any spectra they are still precomputing) and any offscreen framebuffer
+    //       have been freed.
+
+    bool BeginOffscreen(Wave* song, int width, int height);
+    // PRE:  song is initialized, width > 0, height > 0, no song is playing in this widget
+    // POST: FCTVAL == true iff the graphics driver can draw into a framebuffer object. If so, frames of song
+    //       can now be drawn width x height pixels in size with RenderFrame, whether or not the widget is
+    //       shown. Spectra are not precomputed, so the DFT of every frame is taken as it is drawn and is
+    //       the same every run.
+
+    void DrawOffscreen(int vis, long sample);
+    // PRE:  BeginOffscreen succeeded, 0 <= vis < GetNumVisualizations(),
+    //       0 <= sample and sample + 0.005 seconds of audio < length of song
+    // POST: Visualization vis of the frame of song starting at sample sample has been drawn into the
+    //       offscreen framebuffer, which is left bound (and this widget's context current) so the caller
+    //       can read the pixels back with glReadPixels. Visualizations that move over time (the 3D
+    //       carpet's rotation) carry on from the last frame drawn.
+
+    QImage RenderFrame(int vis, long sample);
+    // PRE:  As for DrawOffscreen
+    // POST: FCTVAL == the frame drawn by DrawOffscreen(vis, sample)
+
+    void EndOffscreen();
+    // POST: The offscreen framebuffer is freed, and the widget no longer has a song.
+
+    const FrameProfiler& GetProfiler() const;
+    // POST: FCTVAL == the timings of the frames drawn recently
             
 public slots:
 	void playNewSong(Wave* song);
     // PRE:  song is initialized
     // POST: GLWidget is set up to play song. numSamples is reset to allow for 0.005 seconds of data.
     //         sampleNumber and lastSampleNumber are reset to start of song values, 0 and -1, respectively.
-    //         myTimer is started to allow visualization to synchronize with playback. Qt is set up so
-    //         timerEvent acts as an idle function. 
-    
-	void pauseSong();
-	// POST: Widget is paused on the current frame
+    //         Drawing follows audioClock from here on, and timerEvent is called frameRate times per
+    //         second to draw each frame.
     
     void resumeSong();
-	// POST: If the widget is paused, resumes the widget. Otherwise, starts the widget.
+	// POST: If the widget was stopped, it follows audioClock again. While the audio is paused, audioClock
+	//       holds still, so the widget stays on the current frame without being told. The next frame
+	//       drawn counts no frames dropped during the pause.
     
     void stopSong();
-    // POST: Halts widget, stopping the timer and bringing us back to the first frame.
+    // POST: Halts widget, bringing us back to the first frame until resumeSong or playNewSong is called.
     
     void IncreaseRed();
     // POST: red component of color of visualization is increased by 5%
@@ -72,6 +100,30 @@ public slots:
     void LastVisualization();
     // POST: visualization being displayed is moved to the previous option
 
+    int GetNumVisualizations() const;
+    // POST: FCTVAL == the number of visualizations, numbered from 0 in the order listed in Visualizations.h
+
+    const char* GetVisualizationName(int vis) const;
+    // PRE:  0 <= vis < GetNumVisualizations()
+    // POST: FCTVAL == the name of visualization vis, as shown to the user
+
+    void SetAudioClock(const AudioClock* clock);
+    // PRE:  clock outlives this widget
+    // POST: The frame drawn is chosen from the playback position clock reports.
+
+    void SetFrameRate(int fps);
+    // PRE:  fps > 0
+    // POST: Frames are drawn fps times per second, or as often as the display refreshes if that is less.
+
+    void SetProfileVisible(bool visible);
+    // POST: If visible, every frame shown in the window is overlaid with a summary of how long recent
+    //       frames took to draw, how many were dropped and how far they lagged the audio.
+
+    void SetSpectralCache(bool enabled);
+    // POST: If enabled, the spectrum of every frame of the current and future songs is computed in the
+    //       background as soon as the song is loaded, so the DFT visualization only has to look it up.
+    //       Otherwise, any precomputed spectra are discarded and the DFT is taken as each frame is drawn.
+
 signals:
 	void songEnded();
     // Emitted when there is no more sound data to draw.
@@ -98,22 +150,30 @@ protected:
     //       the time this method is called
     
 	void timerEvent(QTimerEvent *);
-    // POST: sampleNumber is reset to draw the current frame based upon the time that has elapsed since
-    //       the drawing started. If the audio is not over, lastSampleNumber is reset to this value of
+    // POST: sampleNumber is reset to draw the current frame based upon the playback position reported
+    //       by audioClock. If the audio is not over and time has moved on, frameAdvance is set to
+    //       the samples played since the last frame (0 after a seek), lastSampleNumber is reset to
     //       sampleNumber to be used in the next call and the animation is refereshed.
 	
-	void SetVisualization(int vis);
-    // PRE:  0 <= vis <= LAST_VIS_CHOICE
-    // POST: Visualization running changed: 0: Basic Wave, 1: Wavy Oceany Type Thing, 2: Camel Parade, 3: Blob,
-    //       4: Blob plus Wave. When vis > 4, Basic Wave is displayed
+	void SetVisualization(int vis, int step = 1);
+    // PRE:  step is 1 or -1
+    // POST: Visualization running changed to vis (see Visualizations.h), or if the current song lacks what it
+    //       needs, to the next one in the direction of step that can show it. The new visualization starts
+    //       over from its initial view. When vis >= GetNumVisualizations() or vis < 0, Basic Wave is displayed
 	
 private:
     // DATA MEMBERS
 	int numSamples;							
 	long sampleNumber;                      //which sample of the audio is currently being drawn
 	long lastSampleNumber;                  //last sample of audio that was drawn, used for terminating drawing
+	long frameAdvance;                      //samples played between the last two frames drawn
+	int frameRate;                          //frames drawn per second
+	int frameTimerID;                       //Qt timer that calls timerEvent once per frame, or 0 if none
 	Wave* myWave;                            //holds the audio data
-	Timer myTimer;                          //timer for tracking how far into audio we are during visualization
+	const AudioClock* audioClock;           //how far into the audio playback is, as counted by the audio device
+	bool playing;                           //false once stopped, so the frame is no longer taken from audioClock
+	bool glReady;                           //true once initializeGL has run
+	QGLFramebufferObject* offscreen;        //what RenderFrame draws into, or NULL outside BeginOffscreen/EndOffscreen
 	
 	string extension;						//the extension of the file to be played
 	string newFilename;                     //filename with .wav extension
@@ -126,32 +186,58 @@ private:
 	GLfloat blue;							//blue component of line color for drawing
 	
 	int visChoice;                          //which visualization is running. Start with basic waveform.
+	VisualizationRegistry visualizations;   //every visualization, numbered as visChoice counts them
+	FrameInfo frame;                        //the frame being drawn, as handed to the visualization
+	VertexBatch batch;                      //vertices of the frame being drawn, sent to OpenGL in one go
+	WaveShader waveShader;                  //draws waveforms on the graphics card, when it is able to
+
+	FrameProfiler profiler;                 //timings of the frames drawn recently
+	QElapsedTimer profileClock;             //started when the widget is made; times each frame
+	double lastFrameTime;                   //profileClock's reading, in ms, when the last frame was finished, or -1
+	                                        //  if none has been since the profiler was reset or the song resumed
+	bool showProfile;                       //true to overlay the profiler's summary on each frame
+
+	bool precomputeSpectra;                 //true when visualizations may precompute each new song in the background
 
     
+    void LoadSong(Wave* song);
+    //PRE:  song is initialized
+    //POST: myWave == song, numSamples is reset to allow for 0.005 seconds of data, sampleNumber and
+    //      lastSampleNumber are reset to 0 and -1, and every visualization has been loaded with song. If the
+    //      current visualization cannot show song, the next one that can is picked.
+
+    void LoadVisualizations();
+    //PRE:  myWave initialized
+    //POST: Every visualization has been loaded with myWave, precomputing it in the background if
+    //      precomputeSpectra is set.
+
+    void DrawFrame(bool profile);
+    //POST: The window or framebuffer being drawn to has been cleared and, if there is a song, the frame
+    //      of visualization visChoice starting at sampleNumber has been analyzed and drawn into it, under
+    //      the 2D or 3D view it asks for. If profile, its timings have been recorded in profiler.
+
+    void DrawProfile();
+    //POST: The profiler's summary of recent frames has been written over the top left of the window.
+
+    void SetView(bool threeD);
+    //POST: The projection and modelview matrices are set up for 3D visualizations if threeD, otherwise
+    //      for 2D ones, which are drawn on a FRAME_WIDTH x FRAME_HEIGHT window.
+
+    static QGLFormat SyncedFormat();
+    //POST: FCTVAL == a double buffered OpenGL format whose buffer swaps wait for the display's next refresh
+
+    void StartFrameTimer();
+    //POST: Any old frame timer is stopped, and timerEvent is called every 1/frameRate seconds from now on.
+
     // HELPER FUNCTIONS FOR VISUALIZATION FUNCTIONS
-    double MaxAmplitude();                                              //5. 3D Carpet [helper]
+    double PhaseShift();                                                //0.-2., 5. Scrolling waveforms [helper]
+    //PRE:  myWave initialized
+    //POST: FCTVAL == how far the sine waves have scrolled at sampleNumber, in radians (from 0...2*pi). Advances
+    //      by 1 every 1/SCROLL_RATE seconds of audio, smoothly however often frames are drawn.
+
+    void AnalyzeFrame();                                                //frame analysis, shared by all visualizations
     //PRE: myWave initialized
-    //POST: FCTVAL == the maximum amplitude of the wave in the current frame (from 0...1)
-    
-    double WaveHeight(int n, int i);                                    //5. 3D Carpet [helper]
-    //PRE: n < number of channels, i < number of samples per channel
-    //POST: FCTVAL == the intended height of the wave at sample i of channel n used in GLDisplay3DCarpet
-    
-    void SurfaceVertex(int i, int j);                                   //6. 3D Surface [helper]
-    //PRE: i, j < samples per channel
-    //POST: FCTVAL the intended height of the wave at coordinate (i,j) as used in GLDisplay3DSurface
-    
-    
-    // VISUALIZATION FUNCTIONS. For all: 
-    // POST: If audio has completed playing, nothing happens. Otherwise, the GL window is refreshed with a
-    //       graphical representation of ~256 samples (depending on sample rate) of the audio representing 
-    //       0.005 seconds of audio data from the time this method is called
-    void GLDisplayBasicWave();                                           //0. visualization of basic waveform
-    void GLDisplayWavyOceanyTypeThing();                                 //1. "Wavy Oceany Type Thing" Visualization
-    void GLDisplayCamelParade();                                         //2. "Camel Parade" visualization
-    void GLDisplayBlob();                                                //3. "blob" from AS3 visualizer
-    void GLDisplayBlobPlusWave();                                        //4. "blob" from AS3 visualizer + Basic Waveform
-    void GLDisplay3DCarpet();                                            //5. 3D Carpet
-    void GLDisplay3DSurface();                                           //6. 3D Surface
-    void GLDisplayDFT();												 //7. DFT of the basic waveform
+    //POST: frame describes the frame starting at sampleNumber: frame.maxAmplitude == the maximum amplitude
+    //      of the wave in it across all channels (from 0...1), and its position, scroll phase and colors are those
+    //      of the widget
 };
@@ -5,10 +5,13 @@
 #include <string>
 #include "MainWindow.h"
 
-#define curSong (playlist[curTrack].substr(0,playlist[curTrack].length()-3)+"wav").c_str()
-//Used for the filename of the current track in some methods. We always want to be playing the .wav
-//  file, so this extracts the base filename (all but last three characters) with substr and replaces
-//  them with "wav."
+const int VOLUME = 0;                               //live effect controls, as held in the data of effectActs
+const int BASS = 1;
+const int TREBLE = 2;
+const int PITCH = 3;
+
+const int TRACK_READY = 0;                          //states of a track, as held in trackState: it can be played,
+const int TRACK_FAILED = 1;                         //  or ffmpeg could not decode it
 
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
@@ -20,8 +23,13 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 	
 	glWindow = new GLWidget(0);						//Initialize member pointer variables
 	myPlayer = new Player(0);
+	glWindow->SetAudioClock(&myPlayer->GetClock());	//draw whatever the audio device is playing
 	playlistWidget = new QListWidget();	
 	myWave = NULL;	
+	nextWave = NULL;								//nothing decoded ahead yet
+	nextTrack = -1;
+	waiting = false;
+	decoder = new DecodePool(this);					//decodes songs in the background
     
     playlistWidget->clear();                        //Clear playlist initially
 									
@@ -37,10 +45,14 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 		    glWindow, SLOT(playNewSong(Wave*)));	//and GLWidget play the new song
 	
 	connect(glWindow, SIGNAL(songEnded()), 			//When the current song has ended,
-			this, SLOT(gotoNextSong()));			// go to the next song
+			this, SLOT(songEnded()));				// go to the next song, unless the player already has
+	connect(myPlayer, SIGNAL(nextSongStarted(int)),	//The player starts the next song from its audio thread,
+			this, SLOT(nextSongStarted(int)), Qt::QueuedConnection);	// so hear about it on ours
 	
 	connect(playlistWidget, SIGNAL(currentRowChanged(int)), //Handle the playlist being clicked
 		    this, SLOT(listClicked(int)));
+	connect(decoder, SIGNAL(trackReady(int, Wave*)),	//Songs are played or queued as they are decoded
+			this, SLOT(trackReady(int, Wave*)));
 	
 	createDock();									//Create the GUI components
 	createActions();
@@ -52,6 +64,8 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
 MainWindow::~MainWindow()
 //POST: Dynamically allocated memory not handled by Qt is freed.
 {
+	myPlayer->stop();                               //the feeder reads myWave until the player is stopped
+	delete nextWave;
 	delete myWave;
 	myWave = NULL;
 }
@@ -108,7 +122,6 @@ void MainWindow::createActions()
     // Controls toolbar actions
 	pauseAct = new QAction(style()->standardIcon(QStyle::SP_MediaPause), tr("P&ause"), this);
 	connect(pauseAct, SIGNAL(triggered()), myPlayer, SLOT(pause()));
-	connect(pauseAct, SIGNAL(triggered()), glWindow, SLOT(pauseSong()));
 	
 	playAct = new QAction(style()->standardIcon(QStyle::SP_MediaPlay), "P&lay", this);
 	connect(playAct, SIGNAL(triggered()), this, SLOT(resumeTest()));
@@ -149,6 +162,29 @@ void MainWindow::createActions()
     fullScreenAct->setCheckable(true);
     connect(fullScreenAct, SIGNAL(triggered()), this, SLOT(fullScreen()));
     
+    spectralCacheAct = new QAction("Precompute &Spectrum", this);
+    spectralCacheAct->setCheckable(true);
+    spectralCacheAct->setChecked(true);
+    connect(spectralCacheAct, SIGNAL(toggled(bool)), glWindow, SLOT(SetSpectralCache(bool)));
+    
+    frameRateActs = new QActionGroup(this);                 //choosing one rate unchecks the others
+    for (int fps=30; fps <= 120; fps *= 2)
+    {
+        QAction* rateAct = frameRateActs->addAction(QString("%1 fps").arg(fps));
+        rateAct->setData(fps);                              //setFrameRate reads the rate back from here
+        rateAct->setCheckable(true);
+        rateAct->setChecked(fps == DEFAULT_FRAME_RATE);
+    }
+    connect(frameRateActs, SIGNAL(triggered(QAction*)), this, SLOT(setFrameRate(QAction*)));
+    
+    showProfileAct = new QAction("Show Frame &Timings", this);
+    showProfileAct->setShortcut(tr("F3"));
+    showProfileAct->setCheckable(true);
+    connect(showProfileAct, SIGNAL(toggled(bool)), glWindow, SLOT(SetProfileVisible(bool)));
+    
+    saveProfileAct = new QAction("Save Frame Timings...", this);
+    connect(saveProfileAct, SIGNAL(triggered()), this, SLOT(saveFrameTimings()));
+    
     //Playlist actions
     repeatOneAct = new QAction("Repeat &One", this);
     repeatOneAct->setShortcut(tr("Ctrl+T"));
@@ -158,6 +194,49 @@ void MainWindow::createActions()
     repeatAllAct->setShortcut(tr("Ctrl+Alt+T"));
     repeatAllAct->setCheckable(true);
     
+    connect(repeatOneAct, SIGNAL(toggled(bool)), this, SLOT(updatePrefetch()));	//a different song may follow now
+    connect(repeatAllAct, SIGNAL(toggled(bool)), this, SLOT(updatePrefetch()));
+    
+    crossfadeActs = new QActionGroup(this);                 //choosing one length unchecks the others
+    for (int seconds=0; seconds <= 8; seconds = seconds ? seconds*2 : 2)
+    {
+        QAction* fadeAct = crossfadeActs->addAction(seconds ? QString("%1 s").arg(seconds) : QString("&Off"));
+        fadeAct->setData(seconds*1000);                     //setCrossfade reads the length back from here
+        fadeAct->setCheckable(true);
+        fadeAct->setChecked(seconds == 0);
+    }
+    connect(crossfadeActs, SIGNAL(triggered(QAction*)), this, SLOT(setCrossfade(QAction*)));
+    
+    //Audio actions
+    effectActs = new QActionGroup(this);                    //each holds the control it turns and by how much
+    effectActs->setExclusive(false);
+    addEffectAct("Volume &Up", "Ctrl+Up", VOLUME, 3);
+    addEffectAct("Volume &Down", "Ctrl+Down", VOLUME, -3);
+    addEffectAct("More &Bass", "Ctrl+Shift+Up", BASS, 3);
+    addEffectAct("Less B&ass", "Ctrl+Shift+Down", BASS, -3);
+    addEffectAct("More &Treble", "Ctrl+Alt+Up", TREBLE, 3);
+    addEffectAct("Less T&reble", "Ctrl+Alt+Down", TREBLE, -3);
+    addEffectAct("Pitch U&p", "Ctrl+Right", PITCH, 1);
+    addEffectAct("Pitch D&own", "Ctrl+Left", PITCH, -1);
+    connect(effectActs, SIGNAL(triggered(QAction*)), this, SLOT(adjustEffect(QAction*)));
+    
+    resetEffectsAct = new QAction("Reset &Effects", this);
+    connect(resetEffectsAct, SIGNAL(triggered()), this, SLOT(resetEffects()));
+    
+    latencyActs = new QActionGroup(this);                   //choosing one buffer size unchecks the others
+    for (int frames=MIN_BUFFER_FRAMES; frames <= MAX_BUFFER_FRAMES; frames *= 2)
+    {
+        QAction* latencyAct = latencyActs->addAction(QString("%1 frames (%2 ms)").arg(frames)
+                                                     .arg(frames*1000/DEVICE_RATE));
+        latencyAct->setData(frames);                        //setLatency reads the size back from here
+        latencyAct->setCheckable(true);
+        latencyAct->setChecked(frames == AUDIO_BUFFER_FRAMES);
+    }
+    connect(latencyActs, SIGNAL(triggered(QAction*)), this, SLOT(setLatency(QAction*)));
+    
+    audioStatsAct = new QAction("Audio &Statistics...", this);
+    connect(audioStatsAct, SIGNAL(triggered()), this, SLOT(showAudioStats()));
+    
     // About action
     aboutAct = new QAction("&About", this);
     connect(aboutAct, SIGNAL(triggered()), this, SLOT(about()));
@@ -182,11 +261,26 @@ void MainWindow::createMenus()
     visMenu->addAction(prevVisAct);   
     visMenu->addAction(nextVisAct);    
     visMenu->addSeparator();
+    visMenu->addAction(spectralCacheAct);
+    frameRateMenu = visMenu->addMenu("Frame &Rate");
+    frameRateMenu->addActions(frameRateActs->actions());
+    visMenu->addAction(showProfileAct);
+    visMenu->addAction(saveProfileAct);
     visMenu->addAction(fullScreenAct);
     
+    audioMenu = menuBar()->addMenu("&Audio");		//See above
+    audioMenu->addActions(effectActs->actions());
+    audioMenu->addAction(resetEffectsAct);
+    audioMenu->addSeparator();
+    latencyMenu = audioMenu->addMenu("&Latency");
+    latencyMenu->addActions(latencyActs->actions());
+    audioMenu->addAction(audioStatsAct);
+    
     playlistMenu = menuBar()->addMenu("&Playlist");	//See above
     playlistMenu->addAction(repeatOneAct);
     playlistMenu->addAction(repeatAllAct);
+    crossfadeMenu = playlistMenu->addMenu("&Crossfade");
+    crossfadeMenu->addActions(crossfadeActs->actions());
     playlistMenu->addSeparator();
     playlistMenu->addAction(playlistDock->toggleViewAction());
     
@@ -196,20 +290,18 @@ void MainWindow::createMenus()
 
 void MainWindow::createToolBar()
 //POST: Creates a toolbar on the bottom of our window with the following items: "previous," "play,"
-//		"pause," "next," and "stop" buttons, a current song position slider (without scrubbing
-//      functionality), and a "show playlist" toggle.
+//		"pause," "next," and "stop" buttons, a current song position slider that seeks when moved,
+//      and a "show playlist" toggle.
 {
 	slider = new QSlider(Qt::Horizontal);	//create a new slider
 	slider->setRange(0,1000000);			//and set its range (values are arbitrary for now)
 	slider->setValue(0);					//As no song is playing, start the slider at "time" 0.
-	slider->setTracking(false);				//Only emit the "triggered" signal with the mouse is released
-	slider->setEnabled(false);  			//Don't allow for scrubbing because SDL_mixer handles a music
-											//set position for only MP3, OGG, and MOD files. No WAV. :'(.
+	slider->setTracking(false);				//Only change the value once a drag is let go
 	
 	connect(glWindow, SIGNAL(timePassed(int)),	//Use the glWidget's timer to update the slider's position
-		    slider, SLOT(setValue(int)));		//based on percentage of song time completed.
-	//connect(slider, SIGNAL(valueChanged(int)),  //This would handle the scrubbing of our slider if the SDL
-	//		myPlayer, SLOT(scrub(int)));		  //could handle setting the position of a WAV file.
+		    this, SLOT(showTime(int)));			//based on percentage of song time completed.
+	connect(slider, SIGNAL(actionTriggered(int)),	//Seek to wherever the slider is clicked, stepped from the
+			this, SLOT(seek()));					//keyboard or wheel, or let go after a drag
 	
 	controls = new QToolBar();						//initialize our toolbar,
 	addToolBar(Qt::BottomToolBarArea, controls);	//tell our QMainWindow to put it on the bottom,
@@ -223,12 +315,20 @@ void MainWindow::createToolBar()
 	
 	controls->setMinimumHeight(40);					//Set the height of the bar to be 40 pixels
 	controls->setMovable(false);					//Don't let the user move the bar
+	
+	decodeProgress = new QProgressBar();			//shows how far the decode pool has got, while it works
+	decodeProgress->setFormat("Decoding %v of %m");
+	decodeProgress->hide();
+	statusBar()->addPermanentWidget(decodeProgress);
+	connect(decoder, SIGNAL(progress(int, int)), this, SLOT(showDecodeProgress(int, int)));
 }
 
 void MainWindow::open()
 //POST: Clears our playlist, and starts playing the file returned by our file dialog
 {
-	cleanUp();                                      //delete wav files made by last playlist
+	dropPrefetch();									//the song decoded ahead is from the old playlist
+	decoder->cancel();								//so are the tracks still being decoded
+	waiting = false;
 
     playlistWidget->clear();						//clear our playlist
     
@@ -240,23 +340,20 @@ void MainWindow::open()
 void MainWindow::addSong(string fileName)
 //PRE: fileName is initialized to the path of a song of extension ".wav," ".mp3," or ".m4a"
 //POST: Our playlist is populated with the song file located at fileName, numTracks is incremented by one.
-//      If our song is not a .wav, it is converted to a .wav
+//      The song is decoded when it is about to be played.
 {
-	string extension = fileName.substr(fileName.length()-3, 3);					//get the file's extension
-	
-	if (extension == "mp3" || extension == "m4a")								//if file is a .mp3 or .m4a,
-		fileName = createWavOrMP3(fileName)+"."+extension;							//convert it to a .wav
-	
 	playlistWidget->addItem(QFileInfo(QString(fileName.c_str())).fileName());	//add the song name to our playlist
 																				//(stripped of directories)
-																				
 	if(numTracks == playlist.size())											//if playlist has reached full capacity,
+	{
 		playlist.push_back(fileName);											//then we know the next element should be
-																				//stored at the end (and we must prompt a
-																				//resize)
+		trackState.push_back(TRACK_READY);										//stored at the end (and we must prompt a
+	}																			//resize)
 	else
+	{
 		playlist[numTracks] = fileName;											//otherwise, store the filename in the
-																				//appropriate position in our vector.
+		trackState[numTracks] = TRACK_READY;									//appropriate position in our vector.
+	}
 	numTracks++;																//we've added a new track
 }
 
@@ -308,6 +405,8 @@ void MainWindow::addToPlaylist()
 	
 	if (curTrack == -1)												//if we're not playing anything,
 		gotoNextSong();												//start playing the first song of our playlist.
+	else															//otherwise, the current song may now have one
+		updatePrefetch();											//  to follow it.
 }
 
 /* Form of showPlaylist that uses a simple QMessageBox and HTML to show the playlist
@@ -337,22 +436,190 @@ void MainWindow::showPlaylist()
 }*/
 
 void MainWindow::playCurTrack()
-//POST: Starts playing the song as indicated by curTrack
+//POST: Starts playing the song as indicated by curTrack if it has been decoded ahead. Otherwise playback
+//      stops and the track is being decoded, to start once trackReady hands it over; if it could not be
+//      decoded before, playback stops there.
 {
+	string name = QFileInfo(QString(playlist[curTrack].c_str())).fileName().toStdString();	//track's name, for the title
+	
 	playlistWidget->setCurrentRow(curTrack);			//Update the current row of our playlist to show the current track
+	waiting = false;
 	
-	if (myWave)											//if myWave is initialized,
-		delete myWave;									//delete its contents
-		        
-	myWave = new Wave(curSong);							//initialized myWave to the current song as indicated by curTrack
+	if (trackState[curTrack] == TRACK_FAILED)			//nothing to play, ever
+	{
+		glWindow->stopSong();
+		myPlayer->stop();
+		statusBar()->showMessage(("Could not decode " + name).c_str());
+	}
+	else if (nextWave && nextTrack == curTrack)			//if the current track has been decoded ahead, use it;
+	{
+		Wave* song = nextWave;
+		nextWave = NULL;
+		nextTrack = -1;
+		startSong(song);
+	}
+	else												//otherwise wait for it
+	{
+		glWindow->stopSong();
+		myPlayer->stop();
+		waiting = true;
+		setWindowTitle(("GLUI - " + name + " (decoding...)").c_str());
+		if (nextTrack != curTrack)						//unless it is already on its way
+			decoder->decode(curTrack, playlist[curTrack]);
+	}
+}
 
+void MainWindow::startSong(Wave* song)
+//PRE:  song holds the track curTrack, decoded
+//POST: song is myWave and has started playing, the last song has been deleted, and the track after it
+//      is being decoded ahead.
+{
+	Wave* lastWave = myWave;							//song played until now, deleted once the player lets go
+	
+	myWave = song;
 	slider->setRange(0, myWave->GetSongLength()*1000);	//For convenience, the slider range is set from zero to the song
 														//length in milliseconds.
 	
 	setWindowTitle(("GLUI - " + QFileInfo(QString(playlist[curTrack].c_str()))	//Set the window title to the current song
-					.fileName().toStdString()).c_str());						//(stripped of directory structure)
+					.fileName().toStdString()).c_str());
+	
+	emit newSong(myWave);								//send the "new song to start playing" signal. The player
+														//  lets go of lastWave and of anything queued after it.
+	delete lastWave;
+	prefetchNextTrack();								//decode whatever follows while this plays
+}
+
+int MainWindow::followingTrack() const
+//POST: FCTVAL == the index in playlist of the track to play when curTrack ends, as repeat-one and
+//      repeat-all say, or -1 if playback stops there
+{
+	if (curTrack == -1 || numTracks == 0)				//nothing playing
+		return -1;
+	else if (repeatOneAct->isChecked())
+		return curTrack;
+	else if (curTrack < numTracks-1)
+		return curTrack+1;
+	else if (repeatAllAct->isChecked())					//loop forward to the first song
+		return 0;
+	else
+		return -1;
+}
+
+void MainWindow::prefetchNextTrack()
+//POST: Any song decoded ahead has been dropped, and followingTrack() (if there is one) is being decoded
+//      by the decode pool to be queued on the player, unless the player had already started the song
+//      decoded ahead, in which case nextSongStarted picks it up.
+{
+	if (!dropPrefetch())
+		return;
+	
+	nextTrack = followingTrack();
+	if (nextTrack != -1 && trackState[nextTrack] == TRACK_FAILED)	//no use trying again
+		nextTrack = -1;
+	if (nextTrack != -1)
+		decoder->decode(nextTrack, playlist[nextTrack]);
+}
+
+bool MainWindow::dropPrefetch()
+//POST: If the player is not playing nextWave, it has been taken off the player's queue and deleted,
+//      nextTrack is -1 (so its decode is dropped when it arrives), and FCTVAL == true. Otherwise
+//      FCTVAL == false and nextWave is kept for nextSongStarted.
+{
+	myPlayer->queueNextSong(NULL);						//once off the queue, the audio thread cannot start it
+	if (nextWave && myPlayer->getSong() == nextWave)	//but it may have done so already
+		return false;
+	
+	delete nextWave;
+	nextWave = NULL;
+	nextTrack = -1;
+	return true;
+}
+
+void MainWindow::updatePrefetch()
+//POST: If the song to play after the current one has changed (say, repeat was switched on or off), that
+//      song is being decoded ahead in place of the last; if it has not, it is queued on the player
+//      once decoded.
+{
+	if (followingTrack() != nextTrack)
+		prefetchNextTrack();
+	else if (nextWave)									//decoded already, but playNewSong may have emptied the queue
+		myPlayer->queueNextSong(nextWave);
+}
+
+void MainWindow::trackReady(int track, Wave* song)
+//POST: If track was waited on to play, song has started (or, if it is NULL, playback has stopped); if it
+//      is to follow the current track, it has been queued on the player. Otherwise it has been deleted.
+//      A track that could not be decoded is shown in red in the playlist.
+{
+	if (!song)
+	{
+		trackState[track] = TRACK_FAILED;
+		playlistWidget->item(track)->setForeground(Qt::red);
+	}
+	
+	if (waiting && track == curTrack)
+	{
+		if (nextTrack == curTrack)						//it was on its way as the song decoded ahead
+			nextTrack = -1;
+		if (song)
+		{
+			waiting = false;
+			startSong(song);
+		}
+		else
+			playCurTrack();								//says it could not be decoded
+	}
+	else if (song && track == nextTrack && !nextWave)
+	{
+		nextWave = song;
+		myPlayer->queueNextSong(nextWave);				//if it cannot be queued, playCurTrack still uses it
+	}
+	else
+		delete song;									//dropped since it was asked for
+}
+
+void MainWindow::showDecodeProgress(int done, int total)
+//POST: The progress bar shows done of total decodes finished, and is hidden once they all are.
+{
+	decodeProgress->setRange(0, total);
+	decodeProgress->setValue(done);
+	decodeProgress->setVisible(done < total);
+}
+
+void MainWindow::songEnded()
+//POST: If the player has not already carried on with the next song by itself, we go to the next song.
+{
+	if (myPlayer->getNextSong() || myPlayer->getSong() != myWave)	//the handoff is coming in nextSongStarted
+		return;
+	
+	gotoNextSong();
+}
+
+void MainWindow::nextSongStarted(int songNumber)
+//POST: If songNumber is still the player's song number, the song decoded ahead has taken over from the
+//      last one: it is now myWave and curTrack, the visualizer shows it, and the song after it is being
+//      decoded ahead in turn. Otherwise another song was started, or the user picked a track still being
+//      decoded, since; nothing changes.
+{
+	Wave* lastWave = myWave;
+	
+	if (songNumber != myPlayer->getSongNumber() || !nextWave	//stale,
+		|| waiting)												//  or the player was stopped for another track
+		return;
 	
-	emit newSong(myWave);								//send the "new song to start playing" signal.
+	myWave = nextWave;									//nextWave is only queued once decoded
+	nextWave = NULL;
+	curTrack = nextTrack;
+	nextTrack = -1;
+	
+	playlistWidget->setCurrentRow(curTrack);
+	slider->setRange(0, myWave->GetSongLength()*1000);
+	setWindowTitle(("GLUI - " + QFileInfo(QString(playlist[curTrack].c_str()))
+					.fileName().toStdString()).c_str());
+	
+	glWindow->playNewSong(myWave);						//the player is already playing it
+	delete lastWave;									//nobody reads the last song any more
+	prefetchNextTrack();
 }
 
 void MainWindow::gotoPrevSong()
@@ -361,7 +628,10 @@ void MainWindow::gotoPrevSong()
 //      If there is no previous track but repeat-all is on, we loop back to the last song.
 {
 	if (repeatOneAct->isChecked())						//if repeat-one is on,
+	{
 		emit newSong(myWave);							//start the current song from the beginning
+		updatePrefetch();								//and queue its repeat again
+	}
 	else if (curTrack > 0 || repeatAllAct->isChecked()) //If there is a previous song or we're to repeat all,
 	{
 		curTrack--;										//set the current track to the previous song
@@ -385,7 +655,10 @@ void MainWindow::gotoNextSong()
 //      If there is no next track but repeat-all is on, we loop forward to the first song.
 {
 	if (repeatOneAct->isChecked())						//if repeat-one is on,		
+	{
 		emit newSong(myWave);							//start the current song from the beginning
+		updatePrefetch();								//and queue its repeat again
+	}
 	else if (curTrack < numTracks-1 || repeatAllAct->isChecked()) //If there is a next song or we're to repeat all,
 	{
 		curTrack++;										//set the current track to the next song
@@ -401,6 +674,20 @@ void MainWindow::gotoNextSong()
 	}
 }
 
+void MainWindow::showTime(int milliSeconds)
+//POST: Unless the user is dragging it, the slider shows milliSeconds into the song.
+{
+	if (!slider->isSliderDown())			//don't pull the slider out from under the mouse
+		slider->setValue(milliSeconds);
+}
+
+void MainWindow::seek()
+//POST: Unless the user is still dragging it, the song carries on from the time the slider was moved to.
+{
+	if (!slider->isSliderDown())					//a drag seeks once, when it is let go
+		myPlayer->seek(slider->sliderPosition());	//the visualizer follows the player's clock there
+}
+
 void MainWindow::listClicked(int listNum)
 //PRE: listNum < numTracks
 //POST: If the current track is not already that designated by listNum, starts playing the song corresponding
@@ -423,6 +710,9 @@ void MainWindow::resumeTest()
 //POST: If we're currently playing a song, resumes the song.
 //		Otherwise, we start playing the first song in the playlist.
 {
+	if (waiting)					//the current track starts by itself once it is decoded
+		return;
+	
 	if (curTrack != -1)				//If we're currently in the middle of a song,
 	{
 		myPlayer->resume();			//resume the song, if need be.
@@ -436,26 +726,118 @@ void MainWindow::resumeTest()
 }
 
 void MainWindow::quit()
-//POST: Exits the program, deleting any generated .wav files along the way.
+//POST: Exits the program, stopping any ffmpeg still decoding.
 {
-	cleanUp();                      //delete any .wav files we made
+	decoder->cancel();              //so no ffmpeg is left running
 	exit(0);
 }
 
-void MainWindow::cleanUp()
-//POST: Removes the .wav file corresponding to every .mp3 or .m4a file in the playlist
+void MainWindow::setFrameRate(QAction* rateAct)
+//PRE:  rateAct is one of frameRateActs
+//POST: The visualizer draws the number of frames per second held in rateAct's data.
 {
-	string cmd;								//command string to be sent the system
-	for (int i=0;  i < numTracks; i++)		//loop through every track in the playlist
-	{
-		if(playlist[i].substr(playlist[i].length()-3, 3) == "mp3" ||	//if the extension is .mp3 or .m4a,
-		   playlist[i].substr(playlist[i].length()-3, 3) == "m4a")
-		{		
-			//TO BE DONE LATER: HANDLE WINDOWS DELETION
-			cmd = "rm -f \"" + playlist[i].substr(0,playlist[i].length()-3) + "wav\"";	//delete the corresponding
-			system(cmd.c_str());														//.wav
-		}
-	}
+    glWindow->SetFrameRate(rateAct->data().toInt());
+}
+
+void MainWindow::setCrossfade(QAction* fadeAct)
+//PRE:  fadeAct is one of crossfadeActs
+//POST: Songs that follow one another are crossfaded over the number of milliseconds held in fadeAct's data.
+{
+    myPlayer->setCrossfade(fadeAct->data().toInt());
+}
+
+void MainWindow::addEffectAct(const char* name, const char* shortcut, int control, double step)
+//PRE:  control is VOLUME, BASS, TREBLE or PITCH
+//POST: An action named name, with shortcut shortcut, has been added to effectActs to turn control up by
+//      step (in dB, or semitones for PITCH) each time it is triggered.
+{
+    QAction* effectAct = effectActs->addAction(name);
+    
+    effectAct->setShortcut(tr(shortcut));
+    effectAct->setData(QList<QVariant>() << control << step);  //adjustEffect reads them back from here
+}
+
+void MainWindow::adjustEffect(QAction* effectAct)
+//PRE:  effectAct is one of effectActs
+//POST: The control named in effectAct's data has been turned by its step, within limits that keep the
+//      sound recognizable, and the new setting is shown in the status bar.
+{
+    QList<QVariant> data = effectAct->data().toList();
+    int control = data[0].toInt();
+    double step = data[1].toDouble();
+    Gain& gain = myPlayer->getGain();
+    Equalizer& equalizer = myPlayer->getEqualizer();
+    PitchShifter& pitchShifter = myPlayer->getPitchShifter();
+    int band = control == BASS ? 0 : EQ_BANDS-1;            //band turned, for BASS and TREBLE
+    
+    if (control == VOLUME)
+    {
+        gain.SetGain(qBound(-30.0, gain.GetGain()+step, 12.0));
+        statusBar()->showMessage(QString("Volume %1 dB").arg(gain.GetGain()), 2000);
+    }
+    else if (control == PITCH)
+    {
+        pitchShifter.SetSemitones(qBound(-12.0, pitchShifter.GetSemitones()+step, 12.0));
+        statusBar()->showMessage(QString("Pitch %1 semitones").arg(pitchShifter.GetSemitones()), 2000);
+    }
+    else
+    {
+        equalizer.SetBand(band, qBound(-12.0, equalizer.GetBand(band)+step, 12.0));
+        statusBar()->showMessage(QString(control == BASS ? "Bass %1 dB" : "Treble %1 dB")
+                                 .arg(equalizer.GetBand(band)), 2000);
+    }
+}
+
+void MainWindow::resetEffects()
+//POST: Volume, EQ and pitch are back to leaving the sound as it is.
+{
+    myPlayer->getGain().SetGain(0.0);
+    for (int band=0; band < EQ_BANDS; band++)
+        myPlayer->getEqualizer().SetBand(band, 0.0);
+    myPlayer->getPitchShifter().SetSemitones(0.0);
+    statusBar()->showMessage("Effects off", 2000);
+}
+
+void MainWindow::setLatency(QAction* latencyAct)
+//PRE:  latencyAct is one of latencyActs
+//POST: The audio device asks for the number of frames held in latencyAct's data at a time. Smaller blocks
+//      are heard sooner but run dry more easily.
+{
+    myPlayer->setBufferFrames(latencyAct->data().toInt());
+}
+
+void MainWindow::showAudioStats()
+//POST: A message box has shown how hard the player is working to feed the audio device and how often it
+//      has fallen behind.
+{
+    AudioStats stats = myPlayer->getStats();
+    QString message = QString("Blocks fed: %1\n"
+                              "CPU load per block: %2% average, %3% peak\n"
+                              "Blocks over budget: %4\n"
+                              "Underruns: %5\n"
+                              "Device buffer: %6 frames\n"
+                              "Output latency (assumed one block): %7 ms\n"
+                              "Request jitter: %8 ms")
+                      .arg(stats.blocks).arg(stats.averageLoad*100, 0, 'f', 1).arg(stats.peakLoad*100, 0, 'f', 1)
+                      .arg(stats.overBudget).arg(stats.underruns).arg(stats.bufferFrames)
+                      .arg(stats.latency, 0, 'f', 1).arg(stats.jitter, 0, 'f', 1);
+    
+    QMessageBox::information(this, "Audio Statistics", message);
+}
+
+void MainWindow::saveFrameTimings()
+//POST: The timings of the frames drawn recently have been saved as CSV to a file the user picked,
+//      unless they cancelled. If the file could not be written, the user has been told.
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Save Frame Timings", "frames.csv",
+                                                    "CSV files (*.csv)");
+
+    if (!fileName.isEmpty() && !glWindow->GetProfiler().WriteCSV(fileName.toStdString()))
+    {
+        QMessageBox msgBox(QMessageBox::Warning, "Could Not Save",                      //display warning message
+                           "The frame timings could not be written to " + fileName);
+        msgBox.exec();
+    }
 }
 
 void MainWindow::fullScreen()
@@ -503,35 +885,3 @@ void MainWindow::contextMenuEvent(QContextMenuEvent* event)
 	
 	menu.exec(event->globalPos());	//display the context menu
 }
-
-string MainWindow::createWavOrMP3(string fileName)
-//PRE: The file at fileName exists and is a .wav, .mp3, or .m4a
-//	   FFMPEG exists on the current machine and is configured to handle libfaac/libmp3lame
-//POST: If the file is a .mp3 or .m4a, a corresponding .wav is created.
-//		If the file is a .wav, a corresponding .m4a is created
-//		FCTVAL == the base of the fileName (without extension)
-{
-	string fileBase = fileName.substr(0, fileName.length()-4);          //find the base of fileName and store it
-	string extension = fileName.substr(fileName.length()-3, 3);         //find the extension and store it
-	string cmd;                                                         //holder for system command string
-	
-    if(extension == "mp3" || extension == "m4a")                        //if the file is a .mp3 or .m4a
-    {
-        cout << "Converting mp3/m4a to wav temporarily..." << endl;     //display a message
-
-        cmd = "ffmpeg -y -i \"" + fileName								//set the system command to a string that will
-                  + "\" -acodec pcm_s16le \"" + fileBase + ".wav\"";	//convert the file to a .wav
-    }
-    else                                                                //othewise,
-    {
-    	cout << "Converting wav to mp3 temporarily..." << endl;         //display a message
-
-        cmd = "ffmpeg -y -i \"" + fileName + "\" -acodec libmp3lame"	//set the system command to a string that will
-        	  + " -ab 128k \"" + fileBase + ".mp3\"";					//convert the file to a .mp3
-    }
-    
-    if(!system(cmd.c_str()))                                            //try to convert mp3 to wav
-           cout << "";
-   
-    return fileBase;
-}
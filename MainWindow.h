@@ -7,6 +7,7 @@
 #include <vector>
 #include "GLWidget.h"
 #include "Player.h"
+#include "DecodePool.h"
 #include "Wave/Wave.h"
 using namespace std;
 
@@ -38,7 +39,7 @@ public slots:
 	//		to listNum 
 	
     void quit();
-	//POST: Exits the program, deleting any generated .wav files along the way.	
+	//POST: Exits the program, stopping any ffmpeg still decoding.
 	
     void resumeTest();
 	//POST: If we're currently playing a song, resumes the song.
@@ -58,6 +59,55 @@ public slots:
     // POST: If we are to enter fullscreen (as indicated by whether or not our fullscreen action is checked), we
 	//       enter fullscren mode. Otherwise, we leave it.    
     
+    void setFrameRate(QAction* rateAct);
+    //PRE:  rateAct is one of frameRateActs
+    //POST: The visualizer draws the number of frames per second held in rateAct's data.
+    
+    void showTime(int milliSeconds);
+    //POST: Unless the user is dragging it, the slider shows milliSeconds into the song.
+    
+    void seek();
+    //POST: Unless the user is still dragging it, the song carries on from the time the slider was moved to.
+    
+    void songEnded();
+    //POST: If the player has not already carried on with the next song by itself, we go to the next song.
+    
+    void nextSongStarted(int songNumber);
+    //POST: If songNumber is still the player's song number, the song decoded ahead has taken over from the
+    //      last one: it is now myWave and curTrack, the visualizer shows it, and the song after it is being
+    //      decoded ahead in turn. Otherwise another song was started, or the user picked a track still being
+    //      decoded, since; nothing changes.
+    
+    void updatePrefetch();
+    //POST: If the song to play after the current one has changed (say, repeat was switched on or off), that
+    //      song is being decoded ahead in place of the last; if it has not, it is queued on the player
+    //      once decoded.
+    
+    void setCrossfade(QAction* fadeAct);
+    //PRE:  fadeAct is one of crossfadeActs
+    //POST: Songs that follow one another are crossfaded over the number of milliseconds held in fadeAct's data.
+    
+    void adjustEffect(QAction* effectAct);
+    //PRE:  effectAct is one of effectActs
+    //POST: The control named in effectAct's data has been turned by its step, within limits that keep the
+    //      sound recognizable, and the new setting is shown in the status bar.
+    
+    void resetEffects();
+    //POST: Volume, EQ and pitch are back to leaving the sound as it is.
+    
+    void setLatency(QAction* latencyAct);
+    //PRE:  latencyAct is one of latencyActs
+    //POST: The audio device asks for the number of frames held in latencyAct's data at a time. Smaller blocks
+    //      are heard sooner but run dry more easily.
+    
+    void showAudioStats();
+    //POST: A message box has shown how hard the player is working to feed the audio device and how often it
+    //      has fallen behind.
+    
+    void saveFrameTimings();
+    //POST: The timings of the frames drawn recently have been saved as CSV to a file the user picked,
+    //      unless they cancelled. If the file could not be written, the user has been told.
+
     void about();
     //POST: Displays an "about" message box, with information about this program.
 	
@@ -65,6 +115,15 @@ signals:
 	void newSong(Wave* song);
     //Emitted when a new song, song, is to begin playback. 
 	
+private slots:
+	void trackReady(int track, Wave* song);
+	//POST: If track was waited on to play, song has started (or, if it is NULL, playback has stopped); if it
+	//      is to follow the current track, it has been queued on the player. Otherwise it has been deleted.
+	//      A track that could not be decoded is shown in red in the playlist.
+	
+	void showDecodeProgress(int done, int total);
+	//POST: The progress bar shows done of total decodes finished, and is hidden once they all are.
+	
 protected:
 	void contextMenuEvent(QContextMenuEvent* event);
 	//POST: Creates a context menu at the current mouse location with options for increasing the red,
@@ -78,27 +137,48 @@ private:
 	void createActions();
 	//POST: Actions are initialized and connected to the appropriate slots for handling
 	
+	void addEffectAct(const char* name, const char* shortcut, int control, double step);
+	//PRE:  control is VOLUME, BASS, TREBLE or PITCH
+	//POST: An action named name, with shortcut shortcut, has been added to effectActs to turn control up by
+	//      step (in dB, or semitones for PITCH) each time it is triggered.
+	
     void createMenus();
     //POST: Menubar is created with "File," "Visualization," "Playlist," and "Help" menus with 
 	//      connections to appropriate actions
 	
     void createToolBar();
     //POST: Creates a toolbar on the bottom of our window with the following items: "previous," "play,"
-	//		"pause," "next," and "stop" buttons, a current song position slider (without scrubbing
-	//      functionality), and a "show playlist" toggle.
+	//		"pause," "next," and "stop" buttons, a current song position slider that seeks when moved,
+	//      and a "show playlist" toggle.
 	
-    string createWavOrMP3(string fileName);
-    
     void addSong(string fileName);
     //PRE: fileName is initialized to the path of a song of extension ".wav," ".mp3," or ".m4a"
 	//POST: Our playlist is populated with the song file located at fileName, numTracks is incremented by one.
-	//      If our song is not a .wav, it is converted to a .wav
+	//      The song is decoded when it is about to be played.
 	
 	void playCurTrack();
-	//POST: Starts playing the song as indicated by curTrack
+	//POST: Starts playing the song as indicated by curTrack if it has been decoded ahead. Otherwise playback
+	//      stops and the track is being decoded, to start once trackReady hands it over; if it could not be
+	//      decoded before, playback stops there.
+	
+	void startSong(Wave* song);
+	//PRE:  song holds the track curTrack, decoded
+	//POST: song is myWave and has started playing, the last song has been deleted, and the track after it
+	//      is being decoded ahead.
+	
+	int followingTrack() const;
+	//POST: FCTVAL == the index in playlist of the track to play when curTrack ends, as repeat-one and
+	//      repeat-all say, or -1 if playback stops there
 	
-	void cleanUp();
-	//POST: Removes the .wav file corresponding to every .mp3 or .m4a file in the playlist
+	void prefetchNextTrack();
+	//POST: Any song decoded ahead has been dropped, and followingTrack() (if there is one) is being decoded
+	//      by the decode pool to be queued on the player, unless the player had already started the song
+	//      decoded ahead, in which case nextSongStarted picks it up.
+	
+	bool dropPrefetch();
+	//POST: If the player is not playing nextWave, it has been taken off the player's queue and deleted,
+	//      nextTrack is -1 (so its decode is dropped when it arrives), and FCTVAL == true. Otherwise
+	//      FCTVAL == false and nextWave is kept for nextSongStarted.
     
     
     //DATA MEMBERS
@@ -111,12 +191,18 @@ private:
 
     //Minor GUI components
 	QSlider* slider;                //Progress bar -- part of controls ToolBar
+	QProgressBar* decodeProgress;   //Decodes done -- part of the status bar, shown while decoding
     	
     //Back end data
 	Wave* myWave;                   //Wave information
+	Wave* nextWave;                 //song decoded ahead to play after myWave, or NULL while it is decoded
+	int nextTrack;                  //index in playlist of nextWave, or -1 if nothing is decoded ahead
+	DecodePool* decoder;            //decodes songs in the background
+	bool waiting;                   //true while curTrack is to start playing as soon as it is decoded
 	
 	//Playlist management variables
 	vector<string> playlist;		//used as a queue; holds paths of songs to be played
+	vector<int> trackState;			//TRACK_READY or TRACK_FAILED, for each track in playlist
 	int curTrack;					//index in playlist of track currently being played
 	int numTracks;					//how many tracks are currently in playlist; also index of next
                                     // slot where we can insert a track.
@@ -124,7 +210,11 @@ private:
 	// Menus
 	QMenu* fileMenu;                //File
     QMenu* visMenu;                 //Visualization
+    QMenu* frameRateMenu;           //Visualization > Frame Rate
+    QMenu* audioMenu;               //Audio
+    QMenu* latencyMenu;             //Audio > Latency
     QMenu* playlistMenu;            //Playlist
+    QMenu* crossfadeMenu;           //Playlist > Crossfade
     QMenu* helpMenu;                //Help
     
     //Playlist Dock    
@@ -150,9 +240,19 @@ private:
     QAction* prevVisAct;            //Visualization > Previous Visualization
     
     QAction* fullScreenAct;         //Visualization > Go to Full Screen 
+    QAction* spectralCacheAct;      //Visualization > Precompute Spectrum
+    QActionGroup* frameRateActs;    //Visualization > Frame Rate > 30, 60, 120 fps; exactly one is checked
+    QAction* showProfileAct;        //Visualization > Show Frame Timings
+    QAction* saveProfileAct;        //Visualization > Save Frame Timings
     
     QAction* repeatOneAct;          //Playlist > Repeat Track
     QAction* repeatAllAct;          //Playlist > Repeat All
+    QActionGroup* crossfadeActs;    //Playlist > Crossfade > Off, 2, 4, 8 s; exactly one is checked
+    
+    QActionGroup* effectActs;       //Audio > Volume, Bass, Treble and Pitch up and down
+    QAction* resetEffectsAct;       //Audio > Reset Effects
+    QActionGroup* latencyActs;      //Audio > Latency > 256...4096 frames; exactly one is checked
+    QAction* audioStatsAct;         //Audio > Audio Statistics
     
     QAction* aboutAct;              //Application/Help > About
 };
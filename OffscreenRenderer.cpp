@@ -0,0 +1,89 @@
+// OffscreenRenderer: Draws the visualizations of a song into images without showing a window, so
+//                    they can be timed or saved in batch. Frames are rendered by a hidden GLWidget
+//                    into a framebuffer object. On a machine without a display, run under a virtual X
+//                    server with a software OpenGL driver (e.g. xvfb-run with Mesa's llvmpipe).
+
+#include "OffscreenRenderer.h"
+#include <QElapsedTimer>
+#include <QString>
+using namespace std;
+
+OffscreenRenderer::OffscreenRenderer(Wave* song, int width, int height) : widget(0)
+// PRE:  song is initialized and outlives this object, width > 0, height > 0, a QApplication exists
+// POST: A hidden GLWidget has been set up to render frames of song width x height pixels in size.
+{
+    this->song = song;
+    ready = widget.BeginOffscreen(song, width, height);
+}
+
+bool OffscreenRenderer::IsReady() const
+// POST: FCTVAL == true iff the graphics driver can render offscreen. When false, nothing can be rendered.
+{
+    return ready;
+}
+
+int OffscreenRenderer::GetNumFrames(int fps) const
+// PRE:  fps > 0
+// POST: FCTVAL == the number of complete frames in song when it is shown at fps frames per second
+{
+    long lastStart = song->GetSamplesPerChannel()                   //the last frame must still have
+                   - song->GetSampleRate()*256/44100 - 1;           //  0.005 seconds of audio after it
+
+    return lastStart < 0 ? 0 : lastStart*fps/song->GetSampleRate()+1;
+}
+
+void OffscreenRenderer::Draw(int vis, int frame, int fps)
+// PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= frame < GetNumFrames(fps)
+// POST: Visualization vis of frame frame of song, shown at fps frames per second, has been drawn into
+//       the offscreen framebuffer. The framebuffer is left bound and its context current, so the pixels
+//       can be read back with glReadPixels.
+{
+    widget.DrawOffscreen(vis, long(frame)*song->GetSampleRate()/fps);
+}
+
+QImage OffscreenRenderer::Render(int vis, int frame, int fps)
+// PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= frame < GetNumFrames(fps)
+// POST: FCTVAL == visualization vis of frame frame of song, shown at fps frames per second
+{
+    return widget.RenderFrame(vis, long(frame)*song->GetSampleRate()/fps);
+}
+
+bool OffscreenRenderer::RenderRange(int vis, int first, int last, int fps, const string& prefix,
+                                    ostream& report)
+// PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= first <= last < GetNumFrames(fps)
+// POST: Frames first..last of visualization vis have been rendered in order. Unless prefix is empty,
+//       frame n has been saved as prefix followed by n in five digits and ".png". The frame count
+//       and the mean and worst time taken to render a frame have been written to report.
+//       FCTVAL == true iff every frame that was to be saved was saved.
+{
+    QElapsedTimer timer;                    //times each frame
+    double total = 0;                       //milliseconds spent rendering all frames
+    double worst = 0;                       //milliseconds spent on the slowest frame
+    double elapsed;                         //milliseconds spent on the current frame
+    bool saved = true;                      //false once a frame could not be saved
+    QImage image;                           //the current frame
+
+    for (int frame=first; frame <= last; frame++)
+    {
+        timer.start();
+        image = Render(vis, frame, fps);    //includes reading the pixels back, as any real use must
+        elapsed = timer.nsecsElapsed()/1e6;
+
+        total += elapsed;
+        if (elapsed > worst)
+            worst = elapsed;
+
+        if (!prefix.empty())                //saving is not timed
+            saved = image.save(QString::fromStdString(prefix) + QString("%1.png").arg(frame, 5, 10, QChar('0')))
+                 && saved;
+    }
+
+    report << "Rendered " << last-first+1 << " frames of visualization " << vis << ": "
+           << total/(last-first+1) << " ms mean, " << worst << " ms worst, ";
+    if (total > 0)                          //a coarse timer may see no time pass at all
+        report << (last-first+1)*1000/total << " frames per second" << endl;
+    else
+        report << "too fast to time" << endl;
+
+    return saved;
+}
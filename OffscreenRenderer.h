@@ -0,0 +1,50 @@
+// OffscreenRenderer: Draws the visualizations of a song into images without showing a window, so
+//                    they can be timed or saved in batch. Frames are rendered by a hidden GLWidget
+//                    into a framebuffer object. On a machine without a display, run under a virtual X
+//                    server with a software OpenGL driver (e.g. xvfb-run with Mesa's llvmpipe).
+
+#pragma once
+
+#include <QImage>
+#include <iostream>
+#include <string>
+#include "GLWidget.h"
+#include "Wave/Wave.h"
+using namespace std;
+
+class OffscreenRenderer
+{
+public:
+    OffscreenRenderer(Wave* song, int width = FRAME_WIDTH, int height = FRAME_HEIGHT);
+    // PRE:  song is initialized and outlives this object, width > 0, height > 0, a QApplication exists
+    // POST: A hidden GLWidget has been set up to render frames of song width x height pixels in size.
+
+    bool IsReady() const;
+    // POST: FCTVAL == true iff the graphics driver can render offscreen. When false, nothing can be rendered.
+
+    int GetNumFrames(int fps) const;
+    // PRE:  fps > 0
+    // POST: FCTVAL == the number of complete frames in song when it is shown at fps frames per second
+
+    void Draw(int vis, int frame, int fps);
+    // PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= frame < GetNumFrames(fps)
+    // POST: Visualization vis of frame frame of song, shown at fps frames per second, has been drawn into
+    //       the offscreen framebuffer. The framebuffer is left bound and its context current, so the pixels
+    //       can be read back with glReadPixels.
+
+    QImage Render(int vis, int frame, int fps);
+    // PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= frame < GetNumFrames(fps)
+    // POST: FCTVAL == visualization vis of frame frame of song, shown at fps frames per second
+
+    bool RenderRange(int vis, int first, int last, int fps, const string& prefix, ostream& report);
+    // PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0, 0 <= first <= last < GetNumFrames(fps)
+    // POST: Frames first..last of visualization vis have been rendered in order. Unless prefix is empty,
+    //       frame n has been saved as prefix followed by n in five digits and ".png". The frame count
+    //       and the mean and worst time taken to render a frame have been written to report.
+    //       FCTVAL == true iff every frame that was to be saved was saved.
+
+private:
+    GLWidget widget;                        //does the drawing, never shown
+    Wave* song;                             //the song being visualized
+    bool ready;                             //true if widget could set up offscreen rendering
+};
@@ -1,8 +1,22 @@
-// Player - Handles playing music via SDL
+// Player - Handles playing music via SDL. Audio is fed to the device straight from the samples of the
+//          Wave being played, so the file is not read a second time and changes made to the Wave are
+//          heard as soon as they reach the device. The device is opened once, at a fixed rate and number
+//          of channels, and every song is resampled and mixed to that format on its way in, so songs of
+//          any format follow each other without reopening it. A song queued to play next starts on the
+//          very frame after the current one ends. The device's buffer size can be set from 256 to 4096
+//          frames, trading safety from dropouts for latency. The clock is held back by the block the
+//          device is playing, so what is drawn matches what is heard; SDL cannot tell us what the driver
+//          buffers beyond that, so this one-block latency is assumed, not measured. A feeder thread turns
+//          the Wave into 16-bit samples ahead of the device in a lock-free ring buffer, and the audio
+//          callback only copies them out, so it never waits on a lock or allocates memory. The feeder
+//          is also where songs are crossfaded and the live effects (volume, EQ, pitch) are applied.
 // Summer 2009, Evan Fox and Doug Hogan
 
 #include "Player.h"
 #include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 using namespace std;
 
@@ -10,62 +24,621 @@ Player::Player(QObject *parent) : QObject(parent)
 //PRE: parent points to an initialized QObject
 //POST: The player is initialized and ready to play music
 {
-	music = NULL;		//set our pointers to null
-	myWave = NULL;
+	myWave = NULL;		//set our pointer to null
+	nextWave = NULL;	//nothing queued
+	endingWave = NULL;
+	endingPosition = 0;
+	fadeLength = 0;		//no crossfade under way,
+	fadeDone = 0;
+	crossfade = 0;		//and songs follow each other without one
+	boundary = -1;
+	boundaryFrame = 0;
+	songOver = false;
+	underruns = 0;
+	feeding = false;	//no feeder until the device is opened
+	blocksFed = 0;
+	blocksOverBudget = 0;
+	averageLoad = 0.0;
+	peakLoad = 0.0;
+	
+	gain = new Gain();							//the live effects, all doing nothing to begin with
+	equalizer = new Equalizer();
+	pitchShifter = new PitchShifter();
+	effects.Add(gain);
+	effects.Add(equalizer);
+	effects.Add(pitchShifter);
+	songNumber = 0;
+	startedSong = 0;
+	opened = false;		//no audio device until a song is played
+	deviceRate = 0;
+	deviceChannels = 0;
+	bufferFrames = AUDIO_BUFFER_FRAMES;
+	deviceBufferFrames = 0;
+	jitter = 0.0;
+	paused = false;
+	stopped = false;
+	position = 0;
+}
+
+Player::~Player()
+//POST: The audio device is closed and the feeder thread has stopped.
+{
+	closeDevice();
+}
+
+const AudioClock& Player::GetClock() const
+//POST: FCTVAL == the clock measuring how much of the current song the audio device has played
+{
+	return clock;
+}
+
+bool Player::queueNextSong(Wave* song)
+//PRE: song is NULL or points to an initialized Wave object that is not deleted while it is queued or playing
+//POST: If song is not NULL and there is a current song, song replaces any song queued before and will start
+//		playing the moment the current song runs out; otherwise nothing is queued. FCTVAL == true iff song
+//		was queued
+{
+	lock_guard<mutex> hold(feedLock);
+
+	nextWave = myWave ? song : NULL;		//any format will do; it is converted as it is fed
+	return nextWave != NULL;
+}
+
+Wave* Player::getSong() const
+//POST: FCTVAL == the song being fed to the audio device, which may have been queued since the last
+//		nextSongStarted signal was handled
+{
+	lock_guard<mutex> hold(feedLock);
+	return myWave;
+}
+
+Wave* Player::getNextSong() const
+//POST: FCTVAL == the song queued to play next, or NULL if there is none
+{
+	lock_guard<mutex> hold(feedLock);
+	return nextWave;
+}
+
+int Player::getSongNumber() const
+//POST: FCTVAL == how many songs have been started, counting each call to playNewSong and each queued song
+//		that has taken over from the last
+{
+	return songNumber;
+}
+
+Gain& Player::getGain()
+//POST: FCTVAL == the volume control applied to everything played, which may be changed while playing
+{
+	return *gain;
+}
+
+Equalizer& Player::getEqualizer()
+//POST: FCTVAL == the equalizer applied to everything played, which may be changed while playing
+{
+	return *equalizer;
+}
+
+PitchShifter& Player::getPitchShifter()
+//POST: FCTVAL == the pitch shifter applied to everything played, which may be changed while playing
+{
+	return *pitchShifter;
+}
+
+void Player::setCrossfade(int milliSeconds)
+//PRE: milliSeconds >= 0
+//POST: From the next change of song on, a song ending with the next one queued fades out over its last
+//		milliSeconds while the next fades in over it. With 0 they follow each other without a gap.
+{
+	crossfade = milliSeconds;
+}
+
+int Player::getCrossfade() const
+//POST: FCTVAL == the length of a crossfade, in milliseconds
+{
+	return crossfade;
+}
+
+AudioStats Player::getStats() const
+//POST: FCTVAL == how much of the time the feeder has had it has needed to prepare each block, and how
+//		often the device has run short, since the device was opened
+{
+	AudioStats stats;
+
+	stats.blocks = blocksFed;
+	stats.overBudget = blocksOverBudget;
+	stats.averageLoad = averageLoad;
+	stats.peakLoad = peakLoad;
+	stats.underruns = underruns;
+	stats.bufferFrames = deviceBufferFrames;
+	stats.latency = opened ? clock.GetLatency()*1000.0/deviceRate : 0.0;
+	stats.jitter = jitter;
+	return stats;
+}
+
+void Player::setBufferFrames(int frames)
+//PRE: MIN_BUFFER_FRAMES <= frames <= MAX_BUFFER_FRAMES, frames is a power of 2
+//POST: The audio device asks for frames frames at a time from now on, so a frame is heard about that many
+//		frames after it is handed over. If the device was open, it has been reopened with the song carrying
+//		on from what had been heard, paused if it was; if the music was stopped, it is reopened when the
+//		song is resumed or another is played.
+{
+	bool wasPaused = paused;				//what to go back to once the device is reopened
+	double heard = clock.GetSeconds();		//how far into myWave the listener had got
+
+	bufferFrames = frames;
+	if (!opened)							//it will be opened with the new size
+		return;
+
+	closeDevice();							//SDL only takes a buffer size when the device is opened
+	if (stopped)							//myWave may be gone; resume or playNewSong reopens it
+		return;
+
+	position = min<long>(long(heard*deviceRate), deviceLength(*myWave));
+	if (openDevice())
+	{
+		paused = wasPaused;					//the audio thread is not running yet
+		clock.SetRunning(!wasPaused);
+		SDL_PauseAudio(0);
+	}
+}
+
+int Player::getBufferFrames() const
+//POST: FCTVAL == the frames the audio device is set to ask for at a time
+{
+	return bufferFrames;
+}
+
+long Player::getUnderruns() const
+//POST: FCTVAL == how many times the audio device has asked for a block while playing and got less than a
+//		full one because the feeder had fallen behind, rather than because the song was over
+{
+	return underruns;
 }
 
 void Player::playNewSong(Wave* song)
 //PRE: song points to an initialized Wave object
-//POST: the song corresponding to the Wave object starts to play
+//POST: the song corresponding to the Wave object starts to play, and nothing is queued after it. The audio
+//		device is opened the first time; after that, songs are switched without reopening it.
 {
-	myWave = song;		//Update our myWave member
-	stop();				//Stop the current song that is playing
-	resume();			//Let resume handle the playing of the new song
+	if (opened)				//If the device is already open,
+	{						//switch songs between two blocks without stopping the audio thread.
+		lock_guard<mutex> hold(feedLock);
+		SDL_LockAudio();
+		flush();			//drop what was fed of the last song
+		myWave = song;
+		nextWave = NULL;
+		paused = false;
+		stopped = false;
+		position = 0;
+		clock.Reset(deviceRate);		//safe: Advance cannot run while the device is locked
+		clock.SetRunning(true);
+		songNumber++;
+		prime();			//so the next block is not an underrun
+		SDL_UnlockAudio();
+	}
+	else					//otherwise there is no audio thread reading the songs yet.
+	{
+		myWave = song;		//Update our myWave member
+		nextWave = NULL;
+		songNumber++;
+		resume();			//Let resume handle the playing of the new song
+	}
 }
 
 void Player::pause()
 //POST: playing music is paused
 {
-	if (Mix_PlayingMusic())	//If we're playing music,
-		Mix_PauseMusic();	//pause it.
+	if (opened && !paused)			//If we're playing music,
+	{
+		SDL_LockAudio();
+		paused = true;				//give the device silence from now on,
+		SDL_UnlockAudio();
+		clock.SetRunning(false);	//and stop the clock once what the device already has is played.
+	}
 }
 
 void Player::resume()
 //POST: If there is a currently playing song that is paused, resumes that song.
 //		Otherwise, if there is not a currently playing song, starts to play the song
-//		indicated by myWave
-{
-	if (Mix_PausedMusic())					//If there is music paused,
-		Mix_ResumeMusic();					//resume it
-	else if (myWave && !Mix_PlayingMusic())	//If there is music to play and we're not already playing music,
-	{
-		stop();																	//Free any music remaining
-		Mix_OpenAudio(myWave->GetSampleRate(), MIX_DEFAULT_FORMAT, 				//Open audio for playing that is the
-			  myWave->GetNumChannels(), pow(2, myWave->GetQuantization()));		//same sample rate, number of channels,
-																				//and quantization level as the Wave object
-		music = Mix_LoadMUS(myWave->GetFileName().c_str());						//Load the music at the file corresponding
-																				//to the wave object
-	
-		Mix_PlayMusic(music, 1);												//start playing our new song
+//		indicated by myWave, opening the audio device if it is not open yet
+{
+	if (opened && stopped)					//If the music was stopped,
+	{
+		lock_guard<mutex> hold(feedLock);
+		SDL_LockAudio();
+		stopped = false;					//feed the song again from where stop rewound it to,
+		paused = false;
+		prime();
+		clock.SetRunning(true);
+		SDL_UnlockAudio();
+	}
+	else if (opened && paused)				//If there is music paused,
+	{
+		SDL_LockAudio();
+		paused = false;						//resume it
+		SDL_UnlockAudio();
+		clock.SetRunning(true);
+	}
+	else if (myWave && !opened)				//If there is music to play and no device to play it on,
+	{
+		position = 0;						//start from the beginning of the song
+		if (openDevice())					//once the device is open for it.
+			SDL_PauseAudio(0);
 	}
 }
 
 void Player::stop()
-//POST: Removes the "paused" flag, stops the music, frees the music from memory, closes the audio buffer, and resets the
-//		music pointer
+//POST: Removes the "paused" flag, stops the music, and rewinds to the start of the song. The audio device
+//		stays open, playing silence, and nothing more is read from the song until it is resumed or another
+//		is played, so it may be deleted once its replacement is given. Any song queued stays queued.
+{
+	if (opened && !stopped)			//if there is music to stop,
+	{
+		lock_guard<mutex> hold(feedLock);
+		SDL_LockAudio();
+		flush();					//throw away what was fed,
+		stopped = true;				//keep the feeder off the song,
+		paused = true;				//give the device silence,
+		position = 0;				//and rewind.
+		clock.Reset(deviceRate);	//nothing has been played of the next song
+		SDL_UnlockAudio();
+	}
+}
+
+bool Player::openDevice()
+//PRE: The audio device is not open, myWave != NULL, position <= deviceLength(*myWave)
+//POST: If FCTVAL, the device is open at DEVICE_RATE with DEVICE_CHANNELS channels (or as close as it
+//		comes) asking for bufferFrames frames at a time, the buffers and effects are set up for it, the
+//		clock is running from position, and the feeder is running; otherwise the reason has been printed.
+{
+	SDL_AudioSpec desired;					//format we want from the device, whatever the song
+	SDL_AudioSpec obtained;					//format the device really takes
+
+	desired.freq = DEVICE_RATE;
+	desired.format = AUDIO_S16SYS;
+	desired.channels = DEVICE_CHANNELS;
+	desired.samples = bufferFrames;
+	desired.callback = FillAudio;			//the audio thread asks FillAudio for each block
+	desired.userdata = this;
+
+	if (SDL_OpenAudio(&desired, &obtained) < 0)
+	{
+		cerr << "Could not open audio: " << SDL_GetError() << endl;
+		return false;
+	}
+	if (obtained.format != AUDIO_S16SYS)	//we only write 16-bit samples, so let SDL convert them
+	{										//  (its rate and channels are still ours to match)
+		SDL_CloseAudio();
+		if (SDL_OpenAudio(&desired, NULL) < 0)
+		{
+			cerr << "Could not open audio: " << SDL_GetError() << endl;
+			return false;
+		}
+		obtained = desired;
+	}
+
+	opened = true;							//the device starts out paused, so the audio thread is not
+	deviceRate = obtained.freq;				//  running yet
+	deviceChannels = obtained.channels;
+	deviceBufferFrames = obtained.samples;	//SDL may round what was asked for
+	paused = false;
+	stopped = false;
+	ring.Resize(max(4*deviceBufferFrames, MIN_RING_FRAMES)*deviceChannels);
+	mix.assign(deviceChannels, vector<double>(FEED_FRAMES));
+	resampled.assign(deviceChannels, vector<double>(FEED_FRAMES));
+	source.assign(deviceChannels, vector<double>());	//grown to fit as songs need it
+	mixBlock.resize(deviceChannels);
+	resampledBlock.resize(deviceChannels);
+	sourceBlock.resize(deviceChannels);
+	for (int n=0; n < deviceChannels; n++)
+	{
+		mixBlock[n] = &mix[n][0];
+		resampledBlock[n] = &resampled[n][0];
+	}
+	scratch.resize(FEED_FRAMES*deviceChannels);
+	equalizer->SetSampleRate(deviceRate);	//design the effects for the device's rate
+	pitchShifter->SetSampleRate(deviceRate);
+	underruns = 0;							//count afresh for this device
+	blocksFed = 0;
+	blocksOverBudget = 0;
+	averageLoad = 0.0;
+	peakLoad = 0.0;
+	jitter = 0.0;
+	callbacks = 0;
+	flush();
+	prime();								//have the first block ready,
+	clock.Reset(deviceRate);
+	clock.Seek(position);
+	clock.SetLatency(deviceBufferFrames);	//until the device's first request says how big its blocks are
+	clock.SetRunning(true);
+	feeding = true;							//and keep the ring topped up from here on.
+	feeder = thread(&Player::feed, this);
+	return true;
+}
+
+void Player::closeDevice()
+//POST: The feeder has stopped and the audio device is closed, if it was open.
+{
+	int number;								//song the audio thread started that the feeder did not announce
+
+	if (opened)
+	{
+		feeding = false;					//stop the feeder,
+		feeder.join();
+		SDL_CloseAudio();					//then the audio thread.
+		flush();
+		opened = false;
+		if ((number = startedSong.exchange(0)) != 0)	//started as the feeder stopped
+			emit nextSongStarted(number);
+	}
+}
+
+long Player::deviceLength(Wave& song) const
+//PRE: song is initialized, the device is open
+//POST: FCTVAL == the number of frames song lasts at the device's sample rate
+{
+	return ((long long)(song.GetSamplesPerChannel())*deviceRate + song.GetSampleRate() - 1)/song.GetSampleRate();
+}
+
+void Player::FillAudio(void* player, Uint8* stream, int len)
+//PRE: Called by SDL on the audio thread, player points to the Player that opened the audio device
+//POST: stream holds the next len bytes of the ring, or silence while paused or where the ring ran dry.
+//		The frames given have been counted on player's clock; if the first frame of the next song was
+//		among them, the clock has started counting from it and startedSong holds the new song number, for
+//		the feeder to emit nextSongStarted with. The clock's latency is the block asked for, and the
+//		request's timing has been counted in the jitter.
+{
+	Player* me = static_cast<Player*>(player);
+	Sint16* samples = reinterpret_cast<Sint16*>(stream);	//the device's buffer, as 16-bit samples
+	int numChannels = me->deviceChannels;
+	int frames = len/(2*numChannels);						//frames the device asked for
+	unsigned long long first = me->ring.GetRead();			//number in the ring's stream of samples[0]
+	long long start;										//boundary, once the ring has been read
+	int given = 0;											//frames given this time
+	int started = -1;										//frame of stream the next song starts at, if it does
+	int number = 0;											//songNumber once the next song has started
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double early;											//ms between this request and when the last block ran out
+
+	if (me->callbacks++ > 0)								//the device asks as each block starts playing, so
+	{														//  requests should come one block apart
+		early = chrono::duration<double, milli>(now - me->lastCallback).count() - 1000.0*me->lastFrames/me->deviceRate;
+		me->jitter = 0.95*me->jitter + 0.05*fabs(early);
+	}
+	me->lastCallback = now;
+	me->lastFrames = frames;
+	me->clock.SetLatency(frames);							//the block playing now is heard before this one (an
+															//  assumption: SDL does not report the driver's buffering)
+
+	if (!me->paused)
+	{
+		given = me->ring.Read(samples, frames*numChannels)/numChannels;
+		start = me->boundary;								//read after the ring, so it is set if we were given
+		if (start >= 0 && (unsigned long long)(start) < first+given*numChannels)	//  any of the next song
+		{
+			started = (start-first)/numChannels;
+			me->boundary = -1;
+			number = ++me->songNumber;
+		}
+		if (given < frames && !me->songOver)				//the feeder fell behind
+			me->underruns++;
+	}
+	memset(samples+given*numChannels, 0, len-2*given*numChannels);	//silence for the rest
+
+	me->clock.Advance(given, started, me->boundaryFrame);
+	if (started >= 0)										//emitting takes locks and allocates, so the feeder
+		me->startedSong = number;							//  does it for us
+}
+
+void Player::feed()
+//POST: Run on the feeder thread: the ring has been kept topped up with feedBlock, and nextSongStarted
+//		emitted for each song the audio thread started, until feeding was cleared.
+{
+	int fed;												//frames fed this time round
+	int number;												//song the audio thread has started, if any
+
+	while (feeding)
+	{
+		{
+			lock_guard<mutex> hold(feedLock);
+			fed = feedBlock();
+		}
+		if ((number = startedSong.exchange(0)) != 0)
+			emit nextSongStarted(number);					//queued to the GUI thread
+		if (fed == 0)										//the ring is full or there is nothing to feed
+			this_thread::sleep_for(chrono::milliseconds(FEED_SLEEP_MS));
+	}
+}
+
+int Player::feedBlock()
+//PRE: feedLock is held
+//POST: Up to FEED_FRAMES frames, as many as fit, have been taken from myWave (crossfaded with endingWave
+//		while a fade is under way), run through the effects and written to the ring. If myWave was due to
+//		hand over to nextWave, startFade has been called first. FCTVAL == the number of frames written
+{
+	chrono::steady_clock::time_point began = chrono::steady_clock::now();	//to time the block against its budget
+	int frames = min(ring.GetSpace()/deviceChannels, FEED_FRAMES);		//frames to feed
+	long fadeAt;											//frame of myWave to bring nextWave in at
+	double sample;											//current sample, between -1 and 1
+	double load;											//time taken over time the block plays for
+
+	if (frames == 0 || stopped)
+		return 0;
+
+	if (fadeLength == 0 && nextWave && boundary < 0)		//if the next song is queued and the last one has
+	{														//  been reached, it comes in a crossfade before the end:
+		fadeAt = deviceLength(*myWave) - (long long)(crossfade)*deviceRate/1000;
+		if (position >= fadeAt)								//now,
+			startFade();
+		else if (position+frames > fadeAt)					//or after we feed up to there.
+			frames = fadeAt-position;
+	}
+
+	if (fadeLength > 0)										//finish the crossfade exactly,
+		frames = min(frames, fadeLength-fadeDone);
+	else if (position >= deviceLength(*myWave))				//or stop at the end of the song.
+	{
+		songOver = !nextWave;
+		return 0;
+	}
+	else
+		frames = min<long>(frames, deviceLength(*myWave)-position);
+
+	songOver = false;
+	for (int n=0; n < deviceChannels; n++)
+		fill(mix[n].begin(), mix[n].begin()+frames, 0.0);
+	if (fadeLength > 0)
+	{
+		addFrames(*myWave, position, frames, 1);
+		addFrames(*endingWave, endingPosition, frames, -1);
+		endingPosition += frames;
+		fadeDone += frames;
+	}
+	else
+		addFrames(*myWave, position, frames, 0);
+	position += frames;
+
+	effects.Process(&mixBlock[0], deviceChannels, frames);
+
+	for (int i=0; i < frames; i++)							//interleave the channels of each frame
+	{
+		for (int n=0; n < deviceChannels; n++)
+		{
+			sample = mix[n][i];
+			if (sample > 1.0)								//effects may have pushed it out of range
+				sample = 1.0;
+			else if (sample < -1.0)
+				sample = -1.0;
+			scratch[i*deviceChannels+n] = Sint16(floor(sample*32767+0.5));
+		}
+	}
+	ring.Write(&scratch[0], frames*deviceChannels);			//there is room for all of them
+
+	if (fadeLength > 0 && fadeDone == fadeLength)			//the last song has faded out
+	{
+		fadeLength = 0;
+		markBoundary();
+	}
+
+	load = chrono::duration<double>(chrono::steady_clock::now()-began).count()*deviceRate/frames;
+	blocksFed++;
+	if (load > 1.0)
+		blocksOverBudget++;
+	averageLoad = blocksFed == 1 ? load : 0.95*averageLoad + 0.05*load;
+	if (load > peakLoad)
+		peakLoad = load;
+
+	return frames;
+}
+
+void Player::startFade()
+//PRE: feedLock is held or the feeder is not running, nextWave != NULL, boundary < 0, fadeLength == 0
+//POST: nextWave has become myWave, fed from its start, and endingWave is the song before it. What is left
+//		of endingWave (no more than a crossfade) fades out under myWave over the next fadeLength frames;
+//		if nothing is left, boundary already marks where myWave starts.
 {
-	if (music)						//if there is music to stop,
+	long left = deviceLength(*myWave)-position;				//frames of the old song still to be heard
+
+	endingWave = myWave;
+	endingPosition = position;
+	myWave = nextWave;
+	nextWave = NULL;
+	position = 0;
+
+	fadeLength = min(left, deviceLength(*myWave));			//if the new song is shorter than the fade,
+	fadeDone = 0;											//  the old one is cut off at its end
+	if (fadeLength == 0)									//no crossfade: straight on from the next sample
+		markBoundary();
+}
+
+void Player::markBoundary()
+//PRE: feedLock is held or the feeder is not running
+//POST: boundary marks the next sample written to the ring as the one from which the device is
+//		playing myWave alone, boundaryFrame frames into it.
+{
+	boundaryFrame = position;
+	boundary = ring.GetWritten();							//set before the samples after it go in; see FillAudio
+}
+
+void Player::addFrames(Wave& wave, long from, int frames, int fade)
+//PRE: feedLock is held or the feeder is not running, 0 < frames <= FEED_FRAMES,
+//		from+frames <= deviceLength(wave)
+//POST: Frames from...from+frames-1 of wave, counted at the device's rate, have been mixed down to its
+//		channels, resampled to its rate and added to mix: faded in along the crossfade if fade > 0, faded
+//		out if fade < 0, as they are if fade == 0.
+{
+	double weight = 1.0;									//how loud the current frame is
+	double t;												//how far through the crossfade it is (0...1)
+	long first;												//frames of wave, at its own rate, needed for these
+	long last;
+
+	mixer.SetChannels(wave.GetNumChannels(), deviceChannels);
+	resampler.SetRates(wave.GetSampleRate(), deviceRate);
+	resampler.GetSpan(from, frames, wave.GetSamplesPerChannel(), first, last);
+	if (int(source[0].size()) < last-first)				//a higher rate than so far, so more to hold
+		for (int n=0; n < deviceChannels; n++)
+			source[n].resize(last-first);
+	for (int n=0; n < deviceChannels; n++)
+		sourceBlock[n] = source[n].empty() ? NULL : &source[n][0];
+
+	mixer.Process(wave, first, last-first, &sourceBlock[0]);
+	resampler.Process(&sourceBlock[0], deviceChannels, first, last, from, &resampledBlock[0], frames);
+
+	for (int i=0; i < frames; i++)
+	{
+		if (fade != 0)										//equal power, so the overall level holds steady
+		{
+			t = (fadeDone+i+0.5)/fadeLength;
+			weight = fade > 0 ? sin(M_PI/2*t) : cos(M_PI/2*t);
+		}
+		for (int n=0; n < deviceChannels; n++)
+			mix[n][i] += weight*resampled[n][i];
+	}
+}
+
+void Player::prime()
+//PRE: feedLock is held or the feeder is not running, and the audio device is locked or not playing
+//POST: The ring holds at least a block for the device, or everything left to give it.
+{
+	while (ring.GetAvailable() < deviceBufferFrames*deviceChannels && feedBlock() > 0)
+		;
+}
+
+void Player::flush()
+//PRE: feedLock is held or the feeder is not running, and the audio device is locked or closed
+//POST: The ring is empty and the effects' history cleared. If the queued song had been fed in (or faded
+//		in) but the device had not yet reached it alone, it is queued again and the song before it is myWave.
+{
+	ring.Clear();
+	if (boundary >= 0 || fadeLength > 0)					//undo the handoff nobody has heard all of
 	{
-		Mix_ResumeMusic();			//remove the paused flag, if it exists
-		Mix_HaltMusic();			//stop playing the music,
-		Mix_FreeMusic(music);		//free it from memory,
-		Mix_CloseAudio();			//and close the audio buffer.
-		music = NULL; 				//set the music pointer to null.
+		nextWave = myWave;
+		myWave = endingWave;
+		boundary = -1;
+		fadeLength = 0;
 	}
+	songOver = false;
+	effects.Reset();										//no echo of the audio thrown away
 }
 
-/*void Player::scrub(int milliSeconds)
+void Player::seek(int milliSeconds)
+//PRE: milliSeconds >= 0
+//POST: If a song is playing or paused, the next block given to the audio device starts milliSeconds into it
+//		(or at its end, if it is shorter), and the clock has jumped there.
 {
-	Mix_RewindMusic();
-	Mix_SetMusicPosition(milliSeconds/1000.0);
-}*/
+	long frame;								//frame of the song to carry on from
+
+	if (!opened || stopped)					//nothing to seek in
+		return;
+
+	lock_guard<mutex> hold(feedLock);
+	SDL_LockAudio();						//the song is all in memory, so jumping is just moving position
+	flush();								//and dropping what was fed from the old one
+	frame = (long long)(milliSeconds)*deviceRate/1000;
+	if (frame > deviceLength(*myWave))
+		frame = deviceLength(*myWave);
+	position = frame;
+	clock.Seek(frame);						//safe: Advance cannot run while the device is locked
+	prime();
+	SDL_UnlockAudio();
+}
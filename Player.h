@@ -1,20 +1,70 @@
-// Player - Handles playing music via SDL
+// Player - Handles playing music via SDL. Audio is fed to the device straight from the samples of the
+//          Wave being played, so the file is not read a second time and changes made to the Wave are
+//          heard as soon as they reach the device. The device is opened once, at a fixed rate and number
+//          of channels, and every song is resampled and mixed to that format on its way in, so songs of
+//          any format follow each other without reopening it. A song queued to play next starts on the
+//          very frame after the current one ends. The device's buffer size can be set from 256 to 4096
+//          frames, trading safety from dropouts for latency. The clock is held back by the block the
+//          device is playing, so what is drawn matches what is heard; SDL cannot tell us what the driver
+//          buffers beyond that, so this one-block latency is assumed, not measured. A feeder thread turns
+//          the Wave into 16-bit samples ahead of the device in a lock-free ring buffer, and the audio
+//          callback only copies them out, so it never waits on a lock or allocates memory. The feeder
+//          is also where songs are crossfaded and the live effects (volume, EQ, pitch) are applied.
 // Summer 2009, Evan Fox and Doug Hogan
 
 #pragma once
 #include <QObject>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 #include "Wave/Wave.h"
+#include "AudioClock.h"
+#include "RingBuffer.h"
+#include "Wave/EffectChain.h"
+#include "Wave/Equalizer.h"
+#include "Wave/PitchShifter.h"
+#include "Wave/Resampler.h"
+#include "Wave/ChannelMixer.h"
 using namespace std;
 
+#include <SDL/SDL.h>
+
 #ifdef __APPLE__                                  //GLUT, SDL settings different on Apple
-#include <SDL_mixer/SDL_mixer.h>
 #define isApple true
 #else
-#include <SDL/SDL_mixer.h>
 #define isApple false
 #endif
 
+const int DEVICE_RATE = 44100;                    //sample rate asked of the audio device
+const int DEVICE_CHANNELS = 2;                    //number of channels asked of the audio device
+const int MIN_BUFFER_FRAMES = 256;                //fewest frames the audio device may be set to ask for at a time,
+const int MAX_BUFFER_FRAMES = 4096;               //  and the most
+const int AUDIO_BUFFER_FRAMES = 1024;             //frames the audio device asks for at a time, unless set otherwise
+const int MIN_RING_FRAMES = 2048;                 //fewest frames the feeder keeps ready ahead of the device (4 blocks
+                                                  //  if that is more), so small blocks do not run dry while it sleeps
+const int FEED_FRAMES = 1024;                     //most frames the feeder converts at a time
+const int FEED_SLEEP_MS = 2;                      //how long the feeder sleeps while the ring is full
+
+class AudioStats                                  //how well the feeder is keeping up, for monitoring
+{
+public:
+	long blocks;                                  //blocks fed to the ring since the device was opened
+	long overBudget;                              //blocks that took longer to prepare than they take to play
+	double averageLoad;                           //time taken to prepare a block over the time it plays for,
+	                                              //  averaged over recent blocks; 1 is all the time there is
+	double peakLoad;                              //the highest load of any block
+	long underruns;                               //see Player::getUnderruns
+	int bufferFrames;                             //frames the device asks for at a time, as it was opened with
+	double latency;                               //milliseconds between a frame being handed to the device and
+	                                              //  it being heard, assumed to be one block of the size last
+	                                              //  asked for; buffering in the driver is not counted
+	double jitter;                                //how far, on average, the device's requests come early or late,
+	                                              //  in milliseconds
+};
+
 class Player : public QObject
 {
 	Q_OBJECT
@@ -24,10 +74,69 @@ public:
 	//PRE: The QObject referenced by parent is initialized
 	//POST: The player is initialized and ready to play music
 	
+	~Player();
+	//POST: The audio device is closed and the feeder thread has stopped.
+	
+	const AudioClock& GetClock() const;
+	//POST: FCTVAL == the clock measuring how much of the current song the audio device has played
+	
+	bool queueNextSong(Wave* song);
+	//PRE: song is NULL or points to an initialized Wave object that is not deleted while it is queued or playing
+	//POST: If song is not NULL and there is a current song, song replaces any song queued before and will start
+	//		playing the moment the current song runs out; otherwise nothing is queued. FCTVAL == true iff song
+	//		was queued
+	
+	Wave* getSong() const;
+	//POST: FCTVAL == the song being fed to the audio device, which may have been queued since the last
+	//		nextSongStarted signal was handled
+	
+	Wave* getNextSong() const;
+	//POST: FCTVAL == the song queued to play next, or NULL if there is none
+	
+	int getSongNumber() const;
+	//POST: FCTVAL == how many songs have been started, counting each call to playNewSong and each queued song
+	//		that has taken over from the last
+	
+	Gain& getGain();
+	//POST: FCTVAL == the volume control applied to everything played, which may be changed while playing
+	
+	Equalizer& getEqualizer();
+	//POST: FCTVAL == the equalizer applied to everything played, which may be changed while playing
+	
+	PitchShifter& getPitchShifter();
+	//POST: FCTVAL == the pitch shifter applied to everything played, which may be changed while playing
+	
+	void setCrossfade(int milliSeconds);
+	//PRE: milliSeconds >= 0
+	//POST: From the next change of song on, a song ending with the next one queued fades out over its last
+	//		milliSeconds while the next fades in over it. With 0 they follow each other without a gap.
+	
+	int getCrossfade() const;
+	//POST: FCTVAL == the length of a crossfade, in milliseconds
+	
+	AudioStats getStats() const;
+	//POST: FCTVAL == how much of the time the feeder has had it has needed to prepare each block, and how
+	//		often the device has run short, since the device was opened
+	
+	void setBufferFrames(int frames);
+	//PRE: MIN_BUFFER_FRAMES <= frames <= MAX_BUFFER_FRAMES, frames is a power of 2
+	//POST: The audio device asks for frames frames at a time from now on, so a frame is heard about that many
+	//		frames after it is handed over. If the device was open, it has been reopened with the song carrying
+	//		on from what had been heard, paused if it was; if the music was stopped, it is reopened when the
+	//		song is resumed or another is played.
+	
+	int getBufferFrames() const;
+	//POST: FCTVAL == the frames the audio device is set to ask for at a time
+	
+	long getUnderruns() const;
+	//POST: FCTVAL == how many times the audio device has asked for a block while playing and got less than a
+	//		full one because the feeder had fallen behind, rather than because the song was over
+	
 public slots:
 	void playNewSong(Wave* song);
 	//PRE: song points to an initialized Wave object
-	//POST: the song corresponding to the Wave object starts to play
+	//POST: the song corresponding to the Wave object starts to play, and nothing is queued after it. The audio
+	//		device is opened the first time; after that, songs are switched without reopening it.
     
 	void pause();
 	//POST: playing music is paused
@@ -35,14 +144,133 @@ public slots:
 	void resume();
 	//POST: If there is a currently playing song that is paused, resumes that song.
 	//		Otherwise, if there is not a currently playing song, starts to play the song
-	//		indicated by myWave
+	//		indicated by myWave, opening the audio device if it is not open yet
     
 	void stop();
-	//POST: Removes the "paused" flag, stops the music, frees the music from memory, closes the audio buffer, and resets the
-	//		music pointer
-	//void scrub(int milliSeconds);
+	//POST: Removes the "paused" flag, stops the music, and rewinds to the start of the song. The audio device
+	//		stays open, playing silence, and nothing more is read from the song until it is resumed or another
+	//		is played, so it may be deleted once its replacement is given. Any song queued stays queued.
+	
+	void seek(int milliSeconds);
+	//PRE: milliSeconds >= 0
+	//POST: If a song is playing or paused, the next block given to the audio device starts milliSeconds into it
+	//		(or at its end, if it is shorter), and the clock has jumped there.
+
+signals:
+	void nextSongStarted(int songNumber);
+	//Emitted from the feeder thread soon after the queued song takes over from the one that ran out, songNumber
+	//being getSongNumber() as of then. Connect to it with Qt::QueuedConnection.
 
 private:
-	Mix_Music* music;		//SDL object allowing music to be played
+	bool openDevice();
+	//PRE: The audio device is not open, myWave != NULL, position <= deviceLength(*myWave)
+	//POST: If FCTVAL, the device is open at DEVICE_RATE with DEVICE_CHANNELS channels (or as close as it
+	//		comes) asking for bufferFrames frames at a time, the buffers and effects are set up for it, the
+	//		clock is running from position, and the feeder is running; otherwise the reason has been printed.
+	
+	void closeDevice();
+	//POST: The feeder has stopped and the audio device is closed, if it was open.
+	
+	long deviceLength(Wave& song) const;
+	//PRE: song is initialized, the device is open
+	//POST: FCTVAL == the number of frames song lasts at the device's sample rate
+	
+	static void FillAudio(void* player, Uint8* stream, int len);
+	//PRE: Called by SDL on the audio thread, player points to the Player that opened the audio device
+	//POST: stream holds the next len bytes of the ring, or silence while paused or where the ring ran dry.
+	//		The frames given have been counted on player's clock; if the first frame of the next song was
+	//		among them, the clock has started counting from it and startedSong holds the new song number, for
+	//		the feeder to emit nextSongStarted with. The clock's latency is the block asked for, and the
+	//		request's timing has been counted in the jitter.
+	
+	void feed();
+	//POST: Run on the feeder thread: the ring has been kept topped up with feedBlock, and nextSongStarted
+	//		emitted for each song the audio thread started, until feeding was cleared.
+	
+	int feedBlock();
+	//PRE: feedLock is held
+	//POST: Up to FEED_FRAMES frames, as many as fit, have been taken from myWave (crossfaded with endingWave
+	//		while a fade is under way), run through the effects and written to the ring. If myWave was due to
+	//		hand over to nextWave, startFade has been called first. FCTVAL == the number of frames written
+	
+	void startFade();
+	//PRE: feedLock is held or the feeder is not running, nextWave != NULL, boundary < 0, fadeLength == 0
+	//POST: nextWave has become myWave, fed from its start, and endingWave is the song before it. What is left
+	//		of endingWave (no more than a crossfade) fades out under myWave over the next fadeLength frames;
+	//		if nothing is left, boundary already marks where myWave starts.
+	
+	void markBoundary();
+	//PRE: feedLock is held or the feeder is not running
+	//POST: boundary marks the next sample written to the ring as the one from which the device is
+	//		playing myWave alone, boundaryFrame frames into it.
+	
+	void addFrames(Wave& wave, long from, int frames, int fade);
+	//PRE: feedLock is held or the feeder is not running, 0 < frames <= FEED_FRAMES,
+	//		from+frames <= deviceLength(wave)
+	//POST: Frames from...from+frames-1 of wave, counted at the device's rate, have been mixed down to its
+	//		channels, resampled to its rate and added to mix: faded in along the crossfade if fade > 0, faded
+	//		out if fade < 0, as they are if fade == 0.
+	
+	void prime();
+	//PRE: feedLock is held or the feeder is not running, and the audio device is locked or not playing
+	//POST: The ring holds at least a block for the device, or everything left to give it.
+	
+	void flush();
+	//PRE: feedLock is held or the feeder is not running, and the audio device is locked or closed
+	//POST: The ring is empty and the effects' history cleared. If the queued song had been fed in (or faded
+	//		in) but the device had not yet reached it alone, it is queued again and the song before it is myWave.
+	
 	Wave* myWave;			//Wave object containing all the information (file name, sample rate, etc.) about our song
+	AudioClock clock;		//playback position, counted in frames handed to the audio device
+	Wave* nextWave;			//song to carry on with when myWave runs out, or NULL
+	Wave* endingWave;		//song before myWave while it is fading out or boundary >= 0
+	long endingPosition;	//next frame of endingWave to fade out, at the device's rate
+	int fadeLength;			//frames in the crossfade under way, or 0 if there is none
+	int fadeDone;			//frames of it fed so far
+	atomic<int> crossfade;	//see setCrossfade
+	atomic<int> songNumber;	//songs started so far; see getSongNumber
+	atomic<int> startedSong;	//songNumber of a song the audio thread has started, for the feeder to announce; 0 if none
+	bool opened;			//true while the audio device is open
+	int deviceRate;			//sample rate and number of channels the device was opened with
+	int deviceChannels;
+	int bufferFrames;		//frames the device is to ask for at a time; see setBufferFrames
+	int deviceBufferFrames;	//frames it was opened asking for
+	bool paused;			//true while the device should be given silence; changed only under SDL_LockAudio
+	bool stopped;			//true after stop, until a song is resumed or played; changed only under feedLock
+	long position;			//next frame of myWave to feed, counted at the device's rate
+	
+	RingBuffer<Sint16> ring;		//samples fed but not yet given to the device, one frame after another
+	vector<vector<double> > mix;	//FEED_FRAMES frames per channel, mixed and run through the effects
+	vector<double*> mixBlock;		//where each channel of mix starts, as Effect::Process takes them
+	vector<Sint16> scratch;			//mix converted to 16-bit samples on its way into the ring
+	ChannelMixer mixer;				//takes the frames of a song to the device's channels,
+	Resampler resampler;			//and then to its sample rate
+	vector<vector<double> > source;	//frames of a song, mixed down, that resampler needs for one block
+	vector<double*> sourceBlock;	//where each channel of source starts
+	vector<vector<double> > resampled;	//FEED_FRAMES frames per channel, as resampler gives them
+	vector<double*> resampledBlock;		//where each channel of resampled starts
+	atomic<long long> boundary;		//number in the ring's stream of the sample from which the device plays
+									//  myWave alone, while it has not reached it yet; -1 otherwise
+	atomic<long> boundaryFrame;		//frame of myWave that sample belongs to (past any crossfade)
+	atomic<bool> songOver;			//true while there is nothing left to feed, so an empty ring is no underrun
+	atomic<long> underruns;			//see getUnderruns
+	
+	EffectChain effects;			//volume, EQ and pitch, in that order, run on every block fed
+	Gain* gain;						//the effects in the chain, which owns them
+	Equalizer* equalizer;
+	PitchShifter* pitchShifter;
+	
+	atomic<long> blocksFed;			//see AudioStats
+	atomic<long> blocksOverBudget;
+	atomic<double> averageLoad;
+	atomic<double> peakLoad;
+	atomic<double> jitter;
+	long callbacks;			//requests the device has made since it was opened; only the audio thread uses it
+	chrono::steady_clock::time_point lastCallback;	//when the last one came, and how many frames it asked for;
+	int lastFrames;									//  likewise
+	
+	thread feeder;					//runs feed while the device is open
+	atomic<bool> feeding;			//cleared to stop feeder
+	mutable mutex feedLock;			//held by the feeder while it feeds, and by the GUI thread to change what is fed.
+									//  myWave, nextWave, endingWave and position are only changed with it held.
 };
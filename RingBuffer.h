@@ -0,0 +1,165 @@
+// RingBuffer: A fixed-size queue of items passed from exactly one thread to exactly one other without
+//             locks. Each side only moves its own count of the items it has written or read, and
+//             publishes it once the items it covers are in place, so neither side ever waits for the
+//             other or allocates memory. That makes it safe for the reading side to be the audio
+//             callback.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+using namespace std;
+
+template <class T>
+class RingBuffer
+{
+public:
+    RingBuffer(int capacity = 1);
+    // PRE:  capacity > 0
+    // POST: An empty buffer with room for capacity items
+
+    void Resize(int capacity);
+    // PRE:  capacity > 0, neither Write nor Read is running on another thread
+    // POST: The buffer is empty, with room for capacity items.
+
+    void Clear();
+    // PRE:  Neither Write nor Read is running on another thread
+    // POST: The buffer is empty. The counts of items written and read carry on from where they were.
+
+    int Write(const T* source, int count);
+    // PRE:  Called from one thread only (the producer), source holds count items
+    // POST: The first FCTVAL items of source follow those already in the buffer, FCTVAL being count or
+    //       the room left, whichever is less.
+
+    int Read(T* target, int count);
+    // PRE:  Called from one thread only (the consumer), target has room for count items
+    // POST: The oldest FCTVAL items have been taken out of the buffer into target, FCTVAL being count or
+    //       the number in the buffer, whichever is less.
+
+    int GetAvailable() const;
+    // POST: FCTVAL == the number of items in the buffer. Only the consumer can rely on it not shrinking.
+
+    int GetSpace() const;
+    // POST: FCTVAL == the room left in the buffer. Only the producer can rely on it not shrinking.
+
+    int GetCapacity() const;
+    // POST: FCTVAL == the most items the buffer holds at once
+
+    unsigned long long GetWritten() const;
+    // POST: FCTVAL == the number of items ever written, so item n of the stream is in the buffer while
+    //                 GetRead() <= n < GetWritten()
+
+    unsigned long long GetRead() const;
+    // POST: FCTVAL == the number of items ever read
+
+private:
+    vector<T> items;                        //the ring; item n of the stream is kept at n % items.size()
+    atomic<unsigned long long> written;     //items written so far; only the producer changes it
+    atomic<unsigned long long> read;        //items read so far; only the consumer changes it
+};
+
+template <class T>
+RingBuffer<T>::RingBuffer(int capacity) : items(capacity)
+// PRE:  capacity > 0
+// POST: An empty buffer with room for capacity items
+{
+    written = 0;
+    read = 0;
+}
+
+template <class T>
+void RingBuffer<T>::Resize(int capacity)
+// PRE:  capacity > 0, neither Write nor Read is running on another thread
+// POST: The buffer is empty, with room for capacity items.
+{
+    items.assign(capacity, T());
+    Clear();
+}
+
+template <class T>
+void RingBuffer<T>::Clear()
+// PRE:  Neither Write nor Read is running on another thread
+// POST: The buffer is empty. The counts of items written and read carry on from where they were.
+{
+    read = written.load();
+}
+
+template <class T>
+int RingBuffer<T>::Write(const T* source, int count)
+// PRE:  Called from one thread only (the producer), source holds count items
+// POST: The first FCTVAL items of source follow those already in the buffer, FCTVAL being count or
+//       the room left, whichever is less.
+{
+    unsigned long long end = written.load(memory_order_relaxed);   //only this thread changes it
+    unsigned long long start = read.load(memory_order_acquire);    //the consumer is done with items before it
+    int size = items.size();
+    int room = size - int(end-start);
+    int first;                                                      //items that fit before wrapping around
+
+    if (count > room)
+        count = room;
+    first = min(count, size - int(end%size));
+
+    copy(source, source+first, items.begin() + end%size);
+    copy(source+first, source+count, items.begin());
+    written.store(end+count, memory_order_release);                 //publish them to Read
+    return count;
+}
+
+template <class T>
+int RingBuffer<T>::Read(T* target, int count)
+// PRE:  Called from one thread only (the consumer), target has room for count items
+// POST: The oldest FCTVAL items have been taken out of the buffer into target, FCTVAL being count or
+//       the number in the buffer, whichever is less.
+{
+    unsigned long long start = read.load(memory_order_relaxed);    //only this thread changes it
+    unsigned long long end = written.load(memory_order_acquire);   //items before it are in place
+    int size = items.size();
+    int first;                                                      //items before wrapping around
+
+    if (count > int(end-start))
+        count = end-start;
+    first = min(count, size - int(start%size));
+
+    copy(items.begin() + start%size, items.begin() + start%size + first, target);
+    copy(items.begin(), items.begin() + (count-first), target+first);
+    read.store(start+count, memory_order_release);                  //hand the room back to Write
+    return count;
+}
+
+template <class T>
+int RingBuffer<T>::GetAvailable() const
+// POST: FCTVAL == the number of items in the buffer. Only the consumer can rely on it not shrinking.
+{
+    return written.load(memory_order_acquire) - read.load(memory_order_acquire);
+}
+
+template <class T>
+int RingBuffer<T>::GetSpace() const
+// POST: FCTVAL == the room left in the buffer. Only the producer can rely on it not shrinking.
+{
+    return items.size() - GetAvailable();
+}
+
+template <class T>
+int RingBuffer<T>::GetCapacity() const
+// POST: FCTVAL == the most items the buffer holds at once
+{
+    return items.size();
+}
+
+template <class T>
+unsigned long long RingBuffer<T>::GetWritten() const
+// POST: FCTVAL == the number of items ever written, so item n of the stream is in the buffer while
+//                 GetRead() <= n < GetWritten()
+{
+    return written.load(memory_order_acquire);
+}
+
+template <class T>
+unsigned long long RingBuffer<T>::GetRead() const
+// POST: FCTVAL == the number of items ever read
+{
+    return read.load(memory_order_acquire);
+}
@@ -0,0 +1,8 @@
+// wave.frag: Fills waveform visualizations with a single color.
+
+uniform vec4 color;                 //red, green, blue, alpha
+
+void main()
+{
+    gl_FragColor = color;
+}
@@ -0,0 +1,22 @@
+// wave.vert: Places one vertex of a waveform visualization. Every vertex belongs to sample slot.x of
+//            the frame and to edge slot.y (0 or 1) of a strip; each edge has its own layout, so a
+//            filled strip can run between a waveform and the bottom of the screen or between two
+//            waveforms. The height is
+//                center + sineScale*sin(2*pi*slot.x/numSamples + phaseShift) + sampleScale*amplitude
+
+attribute vec2 slot;                //x: sample number within the frame, y: 0 or 1 for the edge of the strip
+attribute float amplitude;          //the audio sample at this vertex, from -1 to 1
+
+uniform float numSamples;           //samples in the frame; one period of the sine spans them
+uniform float xScale;               //horizontal distance between samples, in pixels
+uniform float phaseShift;           //grows steadily with playback time so the sine scrolls
+uniform vec3 edge0;                 //center, sineScale, sampleScale of edge 0 vertices
+uniform vec3 edge1;                 //center, sineScale, sampleScale of edge 1 vertices
+
+void main()
+{
+    vec3 shape = mix(edge0, edge1, slot.y);   //center, sineScale, sampleScale of this vertex
+    float height = shape.x + shape.y*sin(6.283185307*slot.x/numSamples + phaseShift) + shape.z*amplitude;
+
+    gl_Position = gl_ModelViewProjectionMatrix*vec4(slot.x*xScale, height, 0.0, 1.0);
+}
@@ -0,0 +1,110 @@
+// SurfaceMesh: A square grid of vertices drawn as one indexed triangle mesh. The grid's layout on
+//              the floor and the triangles joining it never change for a given size, so they are
+//              built once; each frame only the height of every vertex is filled in and uploaded.
+//              The height at (i,j) is the sum of a row term and a column term, so it takes one
+//              addition per vertex.
+
+#include "SurfaceMesh.h"
+using namespace std;
+
+SurfaceMesh::SurfaceMesh() : vertexBuffer(QGLBuffer::VertexBuffer), indexBuffer(QGLBuffer::IndexBuffer)
+// POST: An empty mesh with no buffers yet
+{
+    size = 0;
+    spacing = 0;
+    numIndices = 0;
+    useBuffers = false;
+}
+
+void SurfaceMesh::Create()
+// PRE:  The OpenGL context that will draw this mesh is current
+// POST: Buffers have been created on the graphics card. If the driver has no buffer support, Draw
+//       will read straight from main memory instead.
+{
+    vertexBuffer.setUsagePattern(QGLBuffer::StreamDraw);    //heights change every frame
+    indexBuffer.setUsagePattern(QGLBuffer::StaticDraw);     //triangles change only with the size
+    useBuffers = vertexBuffer.create() && indexBuffer.create();
+}
+
+void SurfaceMesh::Resize(int size, GLfloat spacing)
+// PRE:  size > 1, spacing > 0
+// POST: The mesh is a size x size grid whose vertex (i,j) lies over (i*spacing, -j*spacing) on the
+//       floor. Nothing is rebuilt if the mesh already had this size and spacing.
+{
+    if (size == this->size && spacing == this->spacing)
+        return;
+
+    this->size = size;
+    this->spacing = spacing;
+
+    vertices.resize(3*size*size);
+    for (int i=0; i < size; i++)                    //lay the grid out on the floor
+        for (int j=0; j < size; j++)
+        {
+            vertices[3*(i*size+j)] = i*spacing;
+            vertices[3*(i*size+j)+1] = 0;
+            vertices[3*(i*size+j)+2] = -j*spacing;
+        }
+
+    indices.clear();
+    for (int i=0; i < size-1; i++)                  //two triangles per grid square, sharing the diagonal
+        for (int j=0; j < size-1; j++)              //  from (i,j) to (i+1,j+1)
+        {
+            GLuint corner = i*size+j;               //vertex number of (i,j)
+
+            indices.push_back(corner);
+            indices.push_back(corner+1);            //(i,j+1)
+            indices.push_back(corner+size+1);       //(i+1,j+1)
+            indices.push_back(corner);
+            indices.push_back(corner+size);         //(i+1,j)
+            indices.push_back(corner+size+1);
+        }
+    numIndices = indices.size();
+
+    if (useBuffers)                                 //the triangles live on the graphics card from now on
+    {
+        indexBuffer.bind();
+        indexBuffer.allocate(&indices[0], numIndices*sizeof(GLuint));
+        indexBuffer.release();
+        vector<GLuint>().swap(indices);
+    }
+}
+
+void SurfaceMesh::Draw(const GLfloat rowHeights[], const GLfloat columnHeights[])
+// PRE:  Create and Resize have been called, rowHeights and columnHeights hold GetSize() values each
+// POST: The mesh has been drawn in the current color, with vertex (i,j) raised to
+//       rowHeights[i]+columnHeights[j]. Each grid square is two triangles split along the diagonal
+//       from (i,j) to (i+1,j+1).
+{
+    GLfloat* y = &vertices[1];                      //height of the vertex being filled in
+
+    for (int i=0; i < size; i++)
+        for (int j=0; j < size; j++, y += 3)
+            *y = rowHeights[i]+columnHeights[j];
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    if (useBuffers)
+    {
+        vertexBuffer.bind();
+        vertexBuffer.allocate(&vertices[0], vertices.size()*sizeof(GLfloat));
+        glVertexPointer(3, GL_FLOAT, 0, NULL);
+        indexBuffer.bind();
+        glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, NULL);
+        indexBuffer.release();
+        vertexBuffer.release();
+    }
+    else
+    {
+        glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
+        glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, &indices[0]);
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+int SurfaceMesh::GetSize() const
+// POST: FCTVAL == number of vertices along each side of the grid
+{
+    return size;
+}
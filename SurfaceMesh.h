@@ -0,0 +1,47 @@
+// SurfaceMesh: A square grid of vertices drawn as one indexed triangle mesh. The grid's layout on
+//              the floor and the triangles joining it never change for a given size, so they are
+//              built once; each frame only the height of every vertex is filled in and uploaded.
+//              The height at (i,j) is the sum of a row term and a column term, so it takes one
+//              addition per vertex.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <vector>
+using namespace std;
+
+class SurfaceMesh
+{
+public:
+    SurfaceMesh();
+    // POST: An empty mesh with no buffers yet
+
+    void Create();
+    // PRE:  The OpenGL context that will draw this mesh is current
+    // POST: Buffers have been created on the graphics card. If the driver has no buffer support, Draw
+    //       will read straight from main memory instead.
+
+    void Resize(int size, GLfloat spacing);
+    // PRE:  size > 1, spacing > 0
+    // POST: The mesh is a size x size grid whose vertex (i,j) lies over (i*spacing, -j*spacing) on the
+    //       floor. Nothing is rebuilt if the mesh already had this size and spacing.
+
+    void Draw(const GLfloat rowHeights[], const GLfloat columnHeights[]);
+    // PRE:  Create and Resize have been called, rowHeights and columnHeights hold GetSize() values each
+    // POST: The mesh has been drawn in the current color, with vertex (i,j) raised to
+    //       rowHeights[i]+columnHeights[j]. Each grid square is two triangles split along the diagonal
+    //       from (i,j) to (i+1,j+1).
+
+    int GetSize() const;
+    // POST: FCTVAL == number of vertices along each side of the grid
+
+private:
+    int size;                               //vertices along each side
+    GLfloat spacing;                        //distance between neighbouring vertices
+    vector<GLfloat> vertices;               //x, y, z of every vertex, row after row; only y changes per frame
+    int numIndices;                         //vertex numbers in the index buffer, three per triangle
+    QGLBuffer vertexBuffer;                 //streaming copy of vertices on the graphics card
+    QGLBuffer indexBuffer;                  //triangles of the grid; fixed per size
+    vector<GLuint> indices;                 //the same triangles, kept when buffers are unavailable
+    bool useBuffers;                        //false when buffers are unavailable
+};
@@ -0,0 +1,144 @@
+// VertexBatch: Collects the vertices of one frame of visualization, with the same Begin/Vertex/End
+//              calls as immediate mode, then uploads them to the graphics card in a single streaming
+//              vertex buffer and draws them with as few glDrawArrays calls as possible.
+
+#include "VertexBatch.h"
+using namespace std;
+
+VertexBatch::VertexBatch() : buffer(QGLBuffer::VertexBuffer)
+// POST: An empty batch with no vertex buffer yet. Vertices are white and lines 1 pixel wide until
+//       changed.
+{
+    Color(1.0, 1.0, 1.0);
+    lineWidth = 1.0;
+    useBuffer = false;
+}
+
+void VertexBatch::Create()
+// PRE:  The OpenGL context that will draw this batch is current
+// POST: A streaming vertex buffer has been created to draw from. If the driver has no vertex buffer
+//       support, Draw will read straight from main memory instead.
+{
+    buffer.setUsagePattern(QGLBuffer::StreamDraw);      //rewritten every frame, drawn once
+    useBuffer = buffer.create();
+}
+
+void VertexBatch::Clear()
+// POST: All vertices and draw calls have been discarded, ready to collect the next frame.
+{
+    vertices.clear();                                   //keeps its memory, so later frames of a similar
+    ranges.clear();                                     //  size cost no allocations
+}
+
+void VertexBatch::Begin(GLenum mode)
+// PRE:  mode is one of the glBegin primitive modes, End has been called since the last Begin
+// POST: Vertices from here to End will be drawn as primitives of type mode.
+{
+    Range range;
+    range.mode = mode;
+    range.first = GetNumVertices();
+    range.count = 0;
+    range.lineWidth = lineWidth;
+    ranges.push_back(range);
+}
+
+void VertexBatch::End()
+// POST: The current primitive is complete. Primitives of a kind that can share a draw call
+//       (points, lines, triangles, quads) are merged with the previous one when nothing about
+//       drawing them differs.
+{
+    Range& current = ranges.back();
+    current.count = GetNumVertices()-current.first;
+
+    if (ranges.size() < 2)
+        return;
+
+    Range& previous = ranges[ranges.size()-2];
+    bool independent = current.mode == GL_POINTS || current.mode == GL_LINES
+                    || current.mode == GL_TRIANGLES || current.mode == GL_QUADS;
+
+    if (independent && previous.mode == current.mode && previous.lineWidth == current.lineWidth
+        && previous.first+previous.count == current.first)
+    {
+        previous.count += current.count;                //one draw call covers both
+        ranges.pop_back();
+    }
+}
+
+void VertexBatch::Vertex(GLfloat x, GLfloat y, GLfloat z)
+// PRE:  Between Begin and End
+// POST: A vertex at (x, y, z) in the current color has been added to the current primitive.
+{
+    vertices.push_back(x);
+    vertices.push_back(y);
+    vertices.push_back(z);
+    vertices.insert(vertices.end(), color, color+4);
+}
+
+void VertexBatch::Color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+// POST: Vertices added from now on are colored (red, green, blue, alpha).
+{
+    color[0] = red;
+    color[1] = green;
+    color[2] = blue;
+    color[3] = alpha;
+}
+
+void VertexBatch::LineWidth(GLfloat width)
+// PRE:  width > 0, not between Begin and End
+// POST: Primitives begun from now on are drawn with lines width pixels wide.
+{
+    lineWidth = width;
+}
+
+void VertexBatch::Draw()
+// PRE:  Create has been called in the current OpenGL context
+// POST: Every vertex collected since the last Clear has been sent to the graphics card in one upload and
+//       drawn, one glDrawArrays call per (merged) primitive, under the current matrices and blending.
+{
+    const GLfloat* base;                                //where the vertex arrays start: an offset into the
+                                                        //  bound buffer, or the vertices themselves
+    int stride = FLOATS_PER_VERTEX*sizeof(GLfloat);     //bytes from one vertex to the next
+
+    if (vertices.empty())
+        return;
+
+    if (useBuffer)
+    {
+        buffer.bind();
+        buffer.allocate(&vertices[0], vertices.size()*sizeof(GLfloat));   //fresh storage every frame, so the
+        base = NULL;                                                        //  driver never waits on the last draw
+    }
+    else
+        base = &vertices[0];
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, base);
+    glColorPointer(4, GL_FLOAT, stride, base+3);
+
+    for (unsigned int r=0; r < ranges.size(); r++)
+    {
+        if (r == 0 || ranges[r].lineWidth != ranges[r-1].lineWidth)
+            glLineWidth(ranges[r].lineWidth);
+        glDrawArrays(ranges[r].mode, ranges[r].first, ranges[r].count);
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    if (useBuffer)
+        buffer.release();
+}
+
+int VertexBatch::GetNumVertices() const
+// POST: FCTVAL == number of vertices collected since the last Clear
+{
+    return vertices.size()/FLOATS_PER_VERTEX;
+}
+
+int VertexBatch::GetNumDrawCalls() const
+// POST: FCTVAL == number of glDrawArrays calls Draw will make
+{
+    return ranges.size();
+}
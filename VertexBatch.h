@@ -0,0 +1,75 @@
+// VertexBatch: Collects the vertices of one frame of visualization, with the same Begin/Vertex/End
+//              calls as immediate mode, then uploads them to the graphics card in a single streaming
+//              vertex buffer and draws them with as few glDrawArrays calls as possible.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <vector>
+using namespace std;
+
+class VertexBatch
+{
+public:
+    VertexBatch();
+    // POST: An empty batch with no vertex buffer yet. Vertices are white and lines 1 pixel wide until
+    //       changed.
+
+    void Create();
+    // PRE:  The OpenGL context that will draw this batch is current
+    // POST: A streaming vertex buffer has been created to draw from. If the driver has no vertex buffer
+    //       support, Draw will read straight from main memory instead.
+
+    void Clear();
+    // POST: All vertices and draw calls have been discarded, ready to collect the next frame.
+
+    void Begin(GLenum mode);
+    // PRE:  mode is one of the glBegin primitive modes, End has been called since the last Begin
+    // POST: Vertices from here to End will be drawn as primitives of type mode.
+
+    void End();
+    // POST: The current primitive is complete. Primitives of a kind that can share a draw call
+    //       (points, lines, triangles, quads) are merged with the previous one when nothing about
+    //       drawing them differs.
+
+    void Vertex(GLfloat x, GLfloat y, GLfloat z = 0);
+    // PRE:  Between Begin and End
+    // POST: A vertex at (x, y, z) in the current color has been added to the current primitive.
+
+    void Color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha = 1.0);
+    // POST: Vertices added from now on are colored (red, green, blue, alpha).
+
+    void LineWidth(GLfloat width);
+    // PRE:  width > 0, not between Begin and End
+    // POST: Primitives begun from now on are drawn with lines width pixels wide.
+
+    void Draw();
+    // PRE:  Create has been called in the current OpenGL context
+    // POST: Every vertex collected since the last Clear has been sent to the graphics card in one upload and
+    //       drawn, one glDrawArrays call per (merged) primitive, under the current matrices and blending.
+
+    int GetNumVertices() const;
+    // POST: FCTVAL == number of vertices collected since the last Clear
+
+    int GetNumDrawCalls() const;
+    // POST: FCTVAL == number of glDrawArrays calls Draw will make
+
+private:
+    class Range                             //a run of vertices drawn with one glDrawArrays call
+    {
+    public:
+        GLenum mode;                        //primitive type
+        int first;                          //index of the first vertex
+        int count;                          //number of vertices
+        GLfloat lineWidth;                  //line width to draw with, in pixels
+    };
+
+    static const int FLOATS_PER_VERTEX = 7; //x, y, z then red, green, blue, alpha, stored side by side
+
+    vector<GLfloat> vertices;               //every vertex of the frame, FLOATS_PER_VERTEX values each
+    vector<Range> ranges;                   //draw calls, in order
+    GLfloat color[4];                       //color given to new vertices
+    GLfloat lineWidth;                      //line width given to new primitives
+    QGLBuffer buffer;                       //streaming vertex buffer on the graphics card
+    bool useBuffer;                         //false when vertex buffers are unavailable
+};
@@ -0,0 +1,263 @@
+// VideoExporter: Renders every frame of a visualization offscreen at a fixed frame rate and streams
+//                them into one video: raw RGB (.rgb), YUV4MPEG2 (.y4m), or anything ffmpeg can write,
+//                through a pipe to ffmpeg along with the song's audio. Frames are read back through two
+//                pixel buffers in turn, so the graphics card copies out one frame while the next is
+//                being drawn and the last is being written.
+
+#include "VideoExporter.h"
+#include <QElapsedTimer>
+#include <stdlib.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include "Utility.h"
+using namespace std;
+
+extern char** environ;                              //passed on to ffmpeg
+
+VideoExporter::VideoExporter(Wave* song, int width, int height) : renderer(song, width, height)
+// PRE:  song is initialized and outlives this object, width > 0, height > 0, a QApplication exists
+// POST: The exporter is set up to render frames of song width x height pixels in size.
+{
+    this->song = song;
+    this->width = width;
+    this->height = height;
+    format = RAW_RGB;
+    output = NULL;
+    ffmpeg = 0;
+    usePixelBuffers = false;
+
+    for (int b=0; b < 2; b++)
+    {
+        pixelBuffers[b] = QGLBuffer(QGLBuffer::PixelPackBuffer);
+        pixelBuffers[b].setUsagePattern(QGLBuffer::StreamRead);   //written by the card, read once by us
+    }
+}
+
+bool VideoExporter::IsReady() const
+// POST: FCTVAL == true iff the graphics driver can render offscreen. When false, nothing can be exported.
+{
+    return renderer.IsReady();
+}
+
+VideoFormat VideoExporter::FormatOf(const string& fileName)
+// POST: FCTVAL == RAW_RGB for a .rgb or .raw file, Y4M for a .y4m file, FFMPEG for anything else
+{
+    string extension = fileName.substr(fileName.find_last_of('.')+1);
+
+    if (extension == "rgb" || extension == "raw")
+        return RAW_RGB;
+    else if (extension == "y4m")
+        return Y4M;
+    else
+        return FFMPEG;
+}
+
+bool VideoExporter::Export(int vis, int fps, const string& fileName, ostream& report)
+// PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0
+// POST: Every frame of visualization vis of song, at fps frames per second, has been written to
+//       fileName in the format FormatOf(fileName). RAW_RGB is 24 bits per pixel, top row first, with
+//       no header. Y4M is full resolution (4:4:4) BT.601. FFMPEG runs ffmpeg, which picks the codec
+//       from the extension and adds the song's audio. How long the export took has been written to
+//       report. FCTVAL == true iff the whole video was written.
+{
+    int numFrames = renderer.GetNumFrames(fps);     //frames in the whole video
+    bool written = true;                            //false once a frame fails to be written
+    QElapsedTimer timer;                            //times the whole export
+
+    format = FormatOf(fileName);
+    if (!Open(fps, fileName, report))
+        return false;
+
+    cout << "Exporting " << numFrames << " frames to " << fileName << endl;
+    timer.start();
+
+    // Frame n is copied back into buffer n%2 while frame n-1, copied back into the other buffer during the
+    // last pass, is written out. Mapping a buffer only has to wait for its copy to finish, which by then
+    // has had a whole frame's drawing to do so.
+    for (int frame=0; frame < numFrames && written; frame++)
+    {
+        renderer.Draw(vis, frame, fps);
+
+        if (frame == 0)                             //the context is current now, so buffers can be made
+            usePixelBuffers = pixelBuffers[0].create() && pixelBuffers[1].create();
+
+        ReadBack(frame%2);
+        if (frame > 0 && usePixelBuffers)
+            written = WriteBack((frame-1)%2);
+        else if (!usePixelBuffers)
+            written = WriteBack(frame%2);
+
+        Utility::Bar(cout, frame+1, numFrames);
+    }
+
+    if (written && numFrames > 0 && usePixelBuffers)   //the last frame is still in its buffer
+        written = WriteBack((numFrames-1)%2);
+
+    written = Close() && written;
+
+    double seconds = timer.nsecsElapsed()/1e9;      //time taken
+    report << endl << (written ? "Exported " : "Failed after ") << numFrames << " frames ("
+           << double(numFrames)/fps << " s of video) in " << seconds << " s, "
+           << numFrames/(fps*seconds) << " times faster than real time" << endl;
+
+    return written;
+}
+
+bool VideoExporter::Open(int fps, const string& fileName, ostream& report)
+// PRE:  fps > 0
+// POST: output is ready to take frames in format. FCTVAL == false, with the reason written to report,
+//       if the file could not be created or ffmpeg could not be run.
+{
+    if (format == FFMPEG)
+    {
+        string size = to_string(width) + "x" + to_string(height);      //WxH for ffmpeg
+        string rate = to_string(fps);
+        string songName = song->GetFileName();
+        const char* args[] = { "ffmpeg", "-loglevel", "error", "-y", "-f", "rawvideo", "-pix_fmt", "rgb24",
+                               "-s", size.c_str(), "-r", rate.c_str(), "-i", "-", "-i", songName.c_str(),
+                               "-map", "0:v", "-map", "1:a", "-pix_fmt", "yuv420p", "-shortest",
+                               fileName.c_str(), NULL };    //no shell, so the names need no quoting
+        int fds[2];                                 //read and write ends of the pipe
+        posix_spawn_file_actions_t actions;
+        int spawned;
+
+        if (pipe(fds) != 0)
+        {
+            report << "Could not make a pipe to ffmpeg." << endl;
+            return false;
+        }
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);         //ffmpeg sees the read end only as its standard input
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+        spawned = posix_spawnp(&ffmpeg, "ffmpeg", &actions, NULL, const_cast<char* const*>(args), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[0]);
+
+        if (spawned != 0)
+        {
+            close(fds[1]);
+            ffmpeg = 0;
+            report << "ffmpeg was not found; export to a .y4m or .rgb file instead." << endl;
+            return false;
+        }
+
+        output = fdopen(fds[1], "wb");              //frames go to ffmpeg's standard input
+        if (!output)
+        {
+            close(fds[1]);                          //ffmpeg sees no input and gives up
+            Close();
+        }
+    }
+    else
+        output = fopen(fileName.c_str(), "wb");
+
+    if (!output)
+    {
+        report << "Could not open " << fileName << " for writing." << endl;
+        return false;
+    }
+
+    if (format == Y4M)                              //progressive, square pixels, no chroma subsampling
+        fprintf(output, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+
+    return true;
+}
+
+bool VideoExporter::Close()
+// POST: output is flushed and closed. FCTVAL == true iff everything written to it arrived, including
+//       ffmpeg finishing successfully.
+{
+    bool closed = output && fclose(output) == 0;    //true if output closed cleanly
+    int status;                                     //how ffmpeg exited
+
+    output = NULL;
+    if (ffmpeg != 0)                                //it has seen the end of its input
+    {
+        while (waitpid(ffmpeg, &status, 0) < 0 && errno == EINTR)
+            ;
+        closed = closed && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        ffmpeg = 0;
+    }
+
+    return closed;
+}
+
+void VideoExporter::ReadBack(int buffer)
+// PRE:  A frame has just been drawn by renderer, 0 <= buffer < 2
+// POST: The graphics card has been asked to copy the frame into pixelBuffers[buffer]. If pixel buffers
+//       are unavailable, the frame has been copied into pixels instead.
+{
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);            //rows are packed tightly, 3 bytes per pixel
+
+    if (usePixelBuffers)
+    {
+        pixelBuffers[buffer].bind();
+        if (pixelBuffers[buffer].size() != 3*width*height)
+            pixelBuffers[buffer].allocate(3*width*height);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, NULL);  //returns without waiting
+        pixelBuffers[buffer].release();
+    }
+    else
+    {
+        pixels.resize(3*width*height);
+        glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+    }
+}
+
+bool VideoExporter::WriteBack(int buffer)
+// PRE:  ReadBack(buffer) has been called since the frame in that buffer was last written
+// POST: The frame in pixelBuffers[buffer] (or pixels) has been written to output. FCTVAL == true iff
+//       it was written in full.
+{
+    const unsigned char* rgb;                       //the frame as the card copied it back
+    bool written;
+
+    if (!usePixelBuffers)
+        return WriteFrame(&pixels[0]);
+
+    pixelBuffers[buffer].bind();
+    rgb = static_cast<const unsigned char*>(pixelBuffers[buffer].map(QGLBuffer::ReadOnly));
+    written = rgb && WriteFrame(rgb);
+    pixelBuffers[buffer].unmap();
+    pixelBuffers[buffer].release();
+    return written;
+}
+
+bool VideoExporter::WriteFrame(const unsigned char* rgb)
+// PRE:  rgb holds width x height pixels of 3 bytes each, bottom row first, as read back from OpenGL
+// POST: The frame has been written to output in format, top row first. FCTVAL == true iff it was
+//       written in full.
+{
+    int planeSize = width*height;                   //bytes in each Y4M plane
+    converted.resize(3*planeSize);
+
+    for (int row=0; row < height; row++)            //OpenGL's first row is the bottom of the picture
+    {
+        const unsigned char* from = rgb + 3*width*(height-1-row);
+
+        if (format != Y4M)                          //RGB rows are just flipped
+            copy(from, from+3*width, converted.begin()+3*width*row);
+        else                                        //Y4M is three planes: luma, blue and red chroma
+        {
+            unsigned char* y = &converted[width*row];
+            unsigned char* cb = y+planeSize;
+            unsigned char* cr = cb+planeSize;
+
+            for (int x=0; x < width; x++, from += 3)    //BT.601, studio range
+            {
+                y[x] = 16.5 + (65.481*from[0] + 128.553*from[1] + 24.966*from[2])/255;
+                cb[x] = 128.5 + (-37.797*from[0] - 74.203*from[1] + 112.0*from[2])/255;
+                cr[x] = 128.5 + (112.0*from[0] - 93.786*from[1] - 18.214*from[2])/255;
+            }
+        }
+    }
+
+    if (format == Y4M && fputs("FRAME\n", output) == EOF)
+        return false;
+    return fwrite(&converted[0], 1, converted.size(), output) == converted.size();
+}
@@ -0,0 +1,78 @@
+// VideoExporter: Renders every frame of a visualization offscreen at a fixed frame rate and streams
+//                them into one video: raw RGB (.rgb), YUV4MPEG2 (.y4m), or anything ffmpeg can write,
+//                through a pipe to ffmpeg along with the song's audio. Frames are read back through two
+//                pixel buffers in turn, so the graphics card copies out one frame while the next is
+//                being drawn and the last is being written.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <stdio.h>
+#include <sys/types.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "OffscreenRenderer.h"
+#include "Wave/Wave.h"
+using namespace std;
+
+enum VideoFormat {RAW_RGB, Y4M, FFMPEG};
+
+class VideoExporter
+{
+public:
+    VideoExporter(Wave* song, int width = FRAME_WIDTH, int height = FRAME_HEIGHT);
+    // PRE:  song is initialized and outlives this object, width > 0, height > 0, a QApplication exists
+    // POST: The exporter is set up to render frames of song width x height pixels in size.
+
+    bool IsReady() const;
+    // POST: FCTVAL == true iff the graphics driver can render offscreen. When false, nothing can be exported.
+
+    static VideoFormat FormatOf(const string& fileName);
+    // POST: FCTVAL == RAW_RGB for a .rgb or .raw file, Y4M for a .y4m file, FFMPEG for anything else
+
+    bool Export(int vis, int fps, const string& fileName, ostream& report);
+    // PRE:  IsReady(), 0 <= vis < GLWidget::GetNumVisualizations(), fps > 0
+    // POST: Every frame of visualization vis of song, at fps frames per second, has been written to
+    //       fileName in the format FormatOf(fileName). RAW_RGB is 24 bits per pixel, top row first, with
+    //       no header. Y4M is full resolution (4:4:4) BT.601. FFMPEG runs ffmpeg, which picks the codec
+    //       from the extension and adds the song's audio. How long the export took has been written to
+    //       report. FCTVAL == true iff the whole video was written.
+
+private:
+    bool Open(int fps, const string& fileName, ostream& report);
+    // PRE:  fps > 0
+    // POST: output is ready to take frames in format. FCTVAL == false, with the reason written to report,
+    //       if the file could not be created or ffmpeg could not be run.
+
+    bool Close();
+    // POST: output is flushed and closed. FCTVAL == true iff everything written to it arrived, including
+    //       ffmpeg finishing successfully.
+
+    void ReadBack(int buffer);
+    // PRE:  A frame has just been drawn by renderer, 0 <= buffer < 2
+    // POST: The graphics card has been asked to copy the frame into pixelBuffers[buffer]. If pixel buffers
+    //       are unavailable, the frame has been copied into pixels instead.
+
+    bool WriteBack(int buffer);
+    // PRE:  ReadBack(buffer) has been called since the frame in that buffer was last written
+    // POST: The frame in pixelBuffers[buffer] (or pixels) has been written to output. FCTVAL == true iff
+    //       it was written in full.
+
+    bool WriteFrame(const unsigned char* rgb);
+    // PRE:  rgb holds width x height pixels of 3 bytes each, bottom row first, as read back from OpenGL
+    // POST: The frame has been written to output in format, top row first. FCTVAL == true iff it was
+    //       written in full.
+
+    OffscreenRenderer renderer;             //draws the frames
+    Wave* song;                             //the song being visualized
+    int width;                              //size of each frame in pixels
+    int height;
+    VideoFormat format;                     //how output is written
+    FILE* output;                           //the video file or the pipe to ffmpeg; NULL when closed
+    pid_t ffmpeg;                           //the ffmpeg output is piped to, while there is one
+    QGLBuffer pixelBuffers[2];              //frames being copied back from the graphics card, in turn
+    bool usePixelBuffers;                   //false when pixel buffers are unavailable
+    vector<unsigned char> pixels;           //frame read back without pixel buffers
+    vector<unsigned char> converted;        //one frame, flipped and converted for writing
+};
@@ -0,0 +1,93 @@
+// Visualization: Base class for anything GLWidget can draw a song with. A visualization is told once
+//                when its OpenGL context is ready and once when each song is loaded, so it can build
+//                its buffers then; each frame it is handed a FrameInfo to analyze and then render.
+//                Its flags say what it needs (stereo audio, a 3D view), and VisualizationRegistry
+//                uses them to skip any that cannot show the current song before drawing starts.
+
+#include "Visualization.h"
+using namespace std;
+
+Visualization::~Visualization()
+// POST: Object is completely removed from virtual memory
+{
+}
+
+int Visualization::GetFlags() const
+// POST: FCTVAL == the flags (NEEDS_STEREO, THREE_D) describing what the visualization needs, or'd together
+{
+    return 0;
+}
+
+bool Visualization::Supports(Wave& song) const
+// PRE:  song is initialized
+// POST: FCTVAL == true iff song has what GetFlags() says the visualization needs
+{
+    return !(GetFlags() & NEEDS_STEREO) || song.GetNumChannels() >= 2;
+}
+
+void Visualization::Create()
+// PRE:  The OpenGL context that will draw this visualization is current
+// POST: Any buffers the visualization keeps on the graphics card have been created.
+{
+}
+
+void Visualization::Load(Wave&, int, bool)
+// PRE:  song is initialized and outlives the visualization's use of it, numSamples > 1
+// POST: The visualization is ready to draw frames of numSamples samples of song, with any per-song
+//       buffers built. If precompute, it may also start working out data for the whole song in the
+//       background.
+{
+}
+
+void Visualization::Start()
+// POST: The visualization starts over from its initial view, as when it is picked.
+{
+}
+
+void Visualization::Analyze(const FrameInfo&)
+// PRE:  Load has been called with frame.wave, Supports(*frame.wave)
+// POST: Whatever the visualization needs to know about frame before drawing it has been worked out.
+{
+}
+
+VisualizationRegistry::~VisualizationRegistry()
+// POST: Every visualization added has been deleted.
+{
+    for (unsigned int i=0; i < visualizations.size(); i++)
+        delete visualizations[i];
+}
+
+void VisualizationRegistry::Add(Visualization* visualization)
+// PRE:  visualization was allocated with new
+// POST: visualization is the last one, numbered GetCount()-1, and is owned by the registry.
+{
+    visualizations.push_back(visualization);
+}
+
+int VisualizationRegistry::GetCount() const
+// POST: FCTVAL == the number of visualizations added
+{
+    return visualizations.size();
+}
+
+Visualization& VisualizationRegistry::operator [](int vis) const
+// PRE:  0 <= vis < GetCount()
+// POST: FCTVAL == visualization number vis
+{
+    return *visualizations[vis];
+}
+
+int VisualizationRegistry::Pick(int vis, int step, Wave* song) const
+// PRE:  GetCount() > 0, step is 1 or -1
+// POST: FCTVAL == vis (wrapped into 0...GetCount()-1) if song is NULL or that visualization supports
+//       it, otherwise the first one that does, stepping by step and wrapping around; 0 if none does
+{
+    int count = GetCount();
+
+    vis = (vis%count + count)%count;                        //wrap around either end
+    for (int tried=0; tried < count; tried++, vis = (vis+step+count)%count)
+        if (!song || visualizations[vis]->Supports(*song))
+            return vis;
+
+    return 0;
+}
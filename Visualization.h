@@ -0,0 +1,101 @@
+// Visualization: Base class for anything GLWidget can draw a song with. A visualization is told once
+//                when its OpenGL context is ready and once when each song is loaded, so it can build
+//                its buffers then; each frame it is handed a FrameInfo to analyze and then render.
+//                Its flags say what it needs (stereo audio, a 3D view), and VisualizationRegistry
+//                uses them to skip any that cannot show the current song before drawing starts.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <vector>
+#include "Wave/Wave.h"
+#include "VertexBatch.h"
+#include "WaveShader.h"
+using namespace std;
+
+const GLint FRAME_WIDTH = 720;           //width of display window in pixels (but it can be resized easily)
+const GLint FRAME_HEIGHT = 450;          //height of display window in pixels
+const int SCROLL_RATE = 12;              //steps per second by which the scrolling sine waves and the DFT advance
+
+const int NEEDS_STEREO = 1;                 //visualization flag: only for songs with at least two channels
+const int THREE_D = 2;                      //visualization flag: drawn under GLWidget's 3D view, not the 2D one
+
+class FrameInfo                             //everything a visualization is given to draw one frame
+{
+public:
+    Wave* wave;                             //the song
+    long sampleNumber;                      //first sample of the frame
+    int numSamples;                         //samples per channel in the frame, 0.005 seconds of audio
+    long advance;                           //samples played since the last frame was drawn
+    double phaseShift;                      //how far scrolling waveforms have moved, in radians (0...2*pi)
+    double maxAmplitude;                    //largest absolute sample of the frame (0...1)
+    GLfloat red;                            //the color picked by the user
+    GLfloat green;
+    GLfloat blue;
+    VertexBatch* batch;                     //collects vertices; drawn by GLWidget after Render returns
+    WaveShader* waveShader;                 //draws waveforms on the graphics card, if IsReady()
+};
+
+class Visualization
+{
+public:
+    virtual ~Visualization();
+    // POST: Object is completely removed from virtual memory
+
+    virtual const char* GetName() const = 0;
+    // POST: FCTVAL == the visualization's name, as shown to the user
+
+    virtual int GetFlags() const;
+    // POST: FCTVAL == the flags (NEEDS_STEREO, THREE_D) describing what the visualization needs, or'd together
+
+    bool Supports(Wave& song) const;
+    // PRE:  song is initialized
+    // POST: FCTVAL == true iff song has what GetFlags() says the visualization needs
+
+    virtual void Create();
+    // PRE:  The OpenGL context that will draw this visualization is current
+    // POST: Any buffers the visualization keeps on the graphics card have been created.
+
+    virtual void Load(Wave& song, int numSamples, bool precompute);
+    // PRE:  song is initialized and outlives the visualization's use of it, numSamples > 1
+    // POST: The visualization is ready to draw frames of numSamples samples of song, with any per-song
+    //       buffers built. If precompute, it may also start working out data for the whole song in the
+    //       background.
+
+    virtual void Start();
+    // POST: The visualization starts over from its initial view, as when it is picked.
+
+    virtual void Analyze(const FrameInfo& frame);
+    // PRE:  Load has been called with frame.wave, Supports(*frame.wave)
+    // POST: Whatever the visualization needs to know about frame before drawing it has been worked out.
+
+    virtual void Render(const FrameInfo& frame) = 0;
+    // PRE:  Analyze(frame) has just been called, the view GetFlags() asks for is set up
+    // POST: frame has been drawn, or added to frame.batch to be drawn straight after.
+};
+
+class VisualizationRegistry
+{
+public:
+    ~VisualizationRegistry();
+    // POST: Every visualization added has been deleted.
+
+    void Add(Visualization* visualization);
+    // PRE:  visualization was allocated with new
+    // POST: visualization is the last one, numbered GetCount()-1, and is owned by the registry.
+
+    int GetCount() const;
+    // POST: FCTVAL == the number of visualizations added
+
+    Visualization& operator [](int vis) const;
+    // PRE:  0 <= vis < GetCount()
+    // POST: FCTVAL == visualization number vis
+
+    int Pick(int vis, int step, Wave* song) const;
+    // PRE:  GetCount() > 0, step is 1 or -1
+    // POST: FCTVAL == vis (wrapped into 0...GetCount()-1) if song is NULL or that visualization supports
+    //       it, otherwise the first one that does, stepping by step and wrapping around; 0 if none does
+
+private:
+    vector<Visualization*> visualizations;  //in the order added
+};
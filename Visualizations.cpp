@@ -0,0 +1,539 @@
+// Visualizations: The visualizations GLWidget comes with, in the order they are numbered:
+//                 0: Basic Wave, 1: Wavy Oceany Type Thing, 2: Camel Parade, 3: Blob, 4: Blob plus Wave,
+//                 5: 3D Carpet, 6: 3D Surface, 7: DFT. Each draws ~256 samples (depending on sample rate),
+//                 0.005 seconds of audio, per frame.
+
+#include "Visualizations.h"
+#include <math.h>
+using namespace std;
+
+void LoadShaderSet(const FrameInfo& frame, vector<GLfloat>& samples, int set, int channel0, int channel1,
+                   bool reverse0)
+//PRE:  samples holds at least set+1 sets of 2*frame.numSamples values, channel0 and channel1 < number of channels
+//POST: Set set of samples holds the frame's samples of channel channel0 on edge 0 (last sample first if reverse0)
+//      and of channel channel1 on edge 1, ready for WaveShader::Upload.
+{
+    int numSamples = frame.numSamples;
+    GLfloat* pairs = &samples[2*set*numSamples];            //where this set starts
+
+    for (int i=0; i < numSamples; i++)
+    {
+        pairs[2*i] = (*frame.wave)[channel0][frame.sampleNumber+(reverse0 ? numSamples-1-i : i)];
+        pairs[2*i+1] = (*frame.wave)[channel1][frame.sampleNumber+i];
+    }
+}
+
+//==============================================================================
+// 0. BASIC WAVE
+//==============================================================================
+
+const char* BasicWave::GetName() const
+{
+    return "Basic Wave";
+}
+
+void BasicWave::Load(Wave& song, int numSamples, bool)
+// POST: The buffer for one frame of numSamples samples of every channel has been made.
+{
+    shaderSamples.resize(2*numSamples*song.GetNumChannels());
+}
+
+void BasicWave::Render(const FrameInfo& frame)
+// POST: Each channel has been drawn as a waveform in its own band of the screen.
+{
+    Wave& wave = *frame.wave;
+    int numSamples = frame.numSamples;
+    VertexBatch& batch = *frame.batch;
+    WaveShader& waveShader = *frame.waveShader;
+
+    if (waveShader.IsReady())                                           //let the graphics card place the points:
+    {                                                                   //  upload each channel as one set...
+        for (int j=0; j<wave.GetNumChannels(); j++)
+            LoadShaderSet(frame, shaderSamples, j, j, j, false);
+
+        glLineWidth(3.0);                                               //set line width to 3 pixels
+        waveShader.Begin(numSamples, GLfloat(FRAME_WIDTH)/numSamples, 0);
+        waveShader.Upload(shaderSamples);
+        waveShader.Color(frame.red, frame.green, frame.blue);
+
+        for (int j=0; j<wave.GetNumChannels(); j++)                     //...and draw it in its own band of the screen
+        {
+            waveShader.Layout(0, FRAME_HEIGHT*(j+1/2.0)/wave.GetNumChannels(), 0,
+                              FRAME_HEIGHT/2.0/wave.GetNumChannels());
+            waveShader.DrawEdge(j, 0, 1);
+        }
+
+        waveShader.End();
+        return;
+    }
+
+    batch.LineWidth(3.0);                                               //set line width to 3 pixels
+    batch.Color(frame.red, frame.green, frame.blue);
+
+    for (int j=0; j<wave.GetNumChannels(); j++)                         //go through each channel of audio
+    {
+        batch.Begin(GL_LINE_STRIP);                                     //make it so points are connected
+        for (int i=1; i<numSamples; i++)                                //draw each point of the current sample
+            batch.Vertex(i*FRAME_WIDTH/numSamples,                      //x coord. moves us across screen
+                         FRAME_HEIGHT/wave.GetNumChannels()             //y coord. is based upon the height
+                         *(j+1/2.0+wave[j][frame.sampleNumber+i]/2));   //  of the sound wave at that instant
+        batch.End();
+    }
+}
+
+//==============================================================================
+// 1. WAVY OCEANY TYPE THING
+//==============================================================================
+
+const char* WavyOceanyTypeThing::GetName() const
+{
+    return "Wavy Oceany Type Thing";
+}
+
+void WavyOceanyTypeThing::Load(Wave&, int numSamples, bool)
+// POST: The buffers for one frame of numSamples samples have been made.
+{
+    shaderSamples.resize(2*numSamples);
+    height.resize(numSamples);
+}
+
+void WavyOceanyTypeThing::Render(const FrameInfo& frame)
+// POST: The left channel has been drawn wrapped around a scrolling sine wave, filled in beneath.
+{
+    int numSamples = frame.numSamples;
+    VertexBatch& batch = *frame.batch;
+    WaveShader& waveShader = *frame.waveShader;
+ 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
+                                                                     //  the horizontal spacing between samples.
+    if (waveShader.IsReady())                                        //let the graphics card place the points. Edge 0
+    {                                                                //  runs along the bottom of the screen, edge 1
+        LoadShaderSet(frame, shaderSamples, 0, 0, 0, false);         //  along the waveform (see below)
+
+        glLineWidth(2.0);                                            //set line width to 2 pixels
+        waveShader.Begin(numSamples, trapWidth, frame.phaseShift);
+        waveShader.Upload(shaderSamples);
+        waveShader.Layout(0, 0, 0, 0);
+        waveShader.Layout(1, FRAME_HEIGHT/2.0, FRAME_HEIGHT/4.0, FRAME_HEIGHT/2.0);
+        waveShader.Color(frame.red/2, frame.green/2, frame.blue/2);  //fill first so it doesn't hide the outline
+        waveShader.DrawStrip(0);
+        waveShader.Color(frame.red, frame.green, frame.blue);
+        waveShader.DrawOutline(0);
+        waveShader.End();
+        return;
+    }
+
+    for (int i=0; i<numSamples; i++)                                 //wrap the waveform around a sine wave half as tall
+        height[i] = FRAME_HEIGHT/2                                   //  as the screen, with one period across the screen
+                  *(1+sin(2*M_PI*double(i)/numSamples+frame.phaseShift)/2
+                    +(*frame.wave)[0][frame.sampleNumber+i]);        //add height of sound wave at each sample
+
+    batch.LineWidth(2.0);                                            //set line width to 2 pixels
+
+    // We wish to fill the area underneath the waveform we draw. However, OpenGL will not fill concave polygons, thus we
+    // draw the outline of the polygon defined by our waveform and the bottom of the screen and fill it in separately. To
+    // fill it in, we run one triangle strip along the bottom of the screen and the waveform, which covers the same
+    // numSamples-1 trapezoids (two triangles each) under the waveform, in a lighter shade of blue. We draw the fill
+    // first so it doesn't hide the outline.
+
+    batch.Color(frame.red/2, frame.green/2, frame.blue/2);                  //set fill color lighter than line color
+
+    batch.Begin(GL_TRIANGLE_STRIP);
+    for (int i=0; i < numSamples; i++)                                      //bottom then top of each trapezoid edge
+    {
+        batch.Vertex(i*trapWidth, 0);
+        batch.Vertex(i*trapWidth, height[i]);
+    }
+    batch.End();
+
+    batch.Color(frame.red, frame.green, frame.blue);
+    batch.Begin(GL_LINE_STRIP);                                 	 		//make it so points form connected line
+    for (int i=0; i<numSamples; i++)                        	 			//draw each point of the current sample
+        batch.Vertex(i*trapWidth, height[i]);                               //x coord. moves us across screen
+
+    batch.Vertex(FRAME_WIDTH, 0);                                           //Draw down to bottom-right corner
+    batch.Vertex(0,0);                                                      //Draw left to bottom-left corner
+    batch.Vertex(0, height[0]);                                             //Draw up to first sample
+    batch.End();
+}
+
+//==============================================================================
+// 2. CAMEL PARADE
+//==============================================================================
+
+const char* CamelParade::GetName() const
+{
+    return "Camel Parade";
+}
+
+int CamelParade::GetFlags() const
+{
+    return NEEDS_STEREO;                                            //one channel at the top, one at the bottom
+}
+
+void CamelParade::Load(Wave&, int numSamples, bool)
+// POST: The buffers for one frame of numSamples samples have been made.
+{
+    shaderSamples.resize(2*numSamples);
+    top.resize(numSamples);
+    bottom.resize(numSamples);
+}
+
+void CamelParade::Render(const FrameInfo& frame)
+// POST: The left channel has been drawn around a scrolling sine wave at the top, the right channel
+//       mirrored beneath it, and the area between them filled in.
+{
+    Wave& wave = *frame.wave;
+    int numSamples = frame.numSamples;
+    VertexBatch& batch = *frame.batch;
+    WaveShader& waveShader = *frame.waveShader;
+ 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
+                                                                     //  the horizontal spacing between samples.
+
+    batch.LineWidth(2.0);                                            //set line width to 2 pixels
+
+    // We wish to fill the area between two waveforms we draw. However, OpenGL will not fill concave polygons, thus we
+    // draw the outline of the polygon defined by our waveform and the bottom of the screen and fill it in separately. To
+    // fill it in, we run one triangle strip between the two waveforms, which covers the same numSamples-1 trapezoids
+    // (two triangles each), in a lighter shade of blue. We draw the fill first so it doesn't hide the outline.
+
+    if (waveShader.IsReady())                                       //let the graphics card place the points. Edge 0
+    {                                                               //  is the right channel, reversed, at the bottom;
+        LoadShaderSet(frame, shaderSamples, 0, 1, 0, true);         //  edge 1 the left channel at the top
+
+        glLineWidth(2.0);                                           //set line width to 2 pixels
+        waveShader.Begin(numSamples, trapWidth, frame.phaseShift);
+        waveShader.Upload(shaderSamples);
+        waveShader.Layout(0, FRAME_HEIGHT/2.0, -FRAME_HEIGHT/4.0, -FRAME_HEIGHT/2.0);
+        waveShader.Layout(1, FRAME_HEIGHT/2.0, FRAME_HEIGHT/4.0, FRAME_HEIGHT/2.0);
+        waveShader.Color(frame.red/2, frame.green/2, frame.blue/2);
+        waveShader.DrawStrip(0);
+        waveShader.Color(frame.red, frame.green, frame.blue);
+        waveShader.DrawEdge(0, 1);
+        waveShader.DrawEdge(0, 0);
+        waveShader.End();
+        return;
+    }
+
+    for (int i=0; i<numSamples; i++)
+    {
+        top[i] = FRAME_HEIGHT/2                                     //wrap y coord. around sine wave half as tall as screen
+               *(1+sin(2*M_PI*double(i)/numSamples+frame.phaseShift)/2	//we have one period across screen
+                 +wave[0][frame.sampleNumber+i]);                   //add height of sound wave at each sample
+        bottom[i] = FRAME_HEIGHT/2                                  //mirror image of the above for the right channel,
+                  *(1-sin(2*M_PI*double(i)/numSamples+frame.phaseShift)/2
+                    -wave[1][frame.sampleNumber+numSamples-1-i]);   //  taking samples measured from the other end
+    }
+
+    // Fill in area between waveforms.
+    batch.Color(frame.red/2, frame.green/2, frame.blue/2);          //set fill color lighter than line color
+
+    batch.Begin(GL_TRIANGLE_STRIP);
+    for (int i=0; i < numSamples; i++)                              //channel 1 then channel 0 at each trapezoid edge
+    {
+        batch.Vertex(i*trapWidth, bottom[i]);
+        batch.Vertex(i*trapWidth, top[i]);
+    }
+    batch.End();
+
+    // Draw waveform for left channel at the top
+    batch.Color(frame.red, frame.green, frame.blue);
+    batch.Begin(GL_LINE_STRIP);                                                 //make it so points form a connected line
+    for (int i=0; i<numSamples; i++)                                            //draw each point of the current sample
+        batch.Vertex(i*trapWidth, top[i]);                                      //x coord. moves us across screen
+    batch.End();
+
+    // Draw waveform for right channel at the bottom, reversed
+    batch.Begin(GL_LINE_STRIP);                                                 //make it so points form a connected line
+    for (int i=0; i < numSamples; i++)
+        batch.Vertex(i*trapWidth, bottom[i]);                                   //match x coordinate with left channel
+    batch.End();
+}
+
+//==============================================================================
+// 3. BLOB
+//==============================================================================
+
+const char* Blob::GetName() const
+{
+    return "Blob";
+}
+
+void Blob::Render(const FrameInfo& frame)
+// POST: Every channel has been drawn around a circle in the middle of the screen, filled in.
+{
+    Wave& wave = *frame.wave;
+    int numSamples = frame.numSamples;
+    VertexBatch& batch = *frame.batch;
+    double radius = FRAME_HEIGHT < FRAME_WIDTH                        //radius of circle about which wave is drawn
+                  ? FRAME_HEIGHT/4                                    //  set based upon smaller screen dimension
+                  : FRAME_WIDTH/4;
+
+    int x;                                                           //x coordinate of current point, in pixels
+    int y;                                                           //y coordinate of current point, in pixels
+    double progress;                                                 //fraction of progress made around the circle
+    double curValue;                                                 //current amplitude of sound wave
+
+    batch.LineWidth(3.0);                                            //set line width to 3 pixels
+    batch.Color(0.0,0x88/0xff,1.0);                                  //set line color to blue
+
+    batch.Begin(GL_TRIANGLE_FAN);                                    //connect points and fill polygon (fanned out
+                                                                     //  from the first point, as GL_POLYGON was)
+    for (int j=0; j<wave.GetNumChannels(); j++)                      //go through each channel of audio
+    {
+        for (int i=0; i<numSamples; i++)                             //draw each point of the current sample
+        {
+            progress = double(i + j*numSamples)                       //account for previous channels plus how far into this one
+                     / (numSamples*wave.GetNumChannels()-1);          //we have numSamples points to draw in each channel
+
+            batch.Color(0, .2+.8*progress, .2+.8*progress);
+
+            if(j%2 == 1)                                                //odd channels drawn in forward order
+                curValue = wave[j][frame.sampleNumber+i];
+            else                                                        //even channels drawn in reverse order
+                curValue = wave[j][frame.sampleNumber+numSamples-i];
+
+            x = FRAME_WIDTH/2 + radius*cos(360*progress*M_PI/180)       //location of this point if we were drawing a circle
+              * (1-curValue);                                           //offset radius based upon current data
+            y = FRAME_HEIGHT/2 -radius*sin(360*progress*M_PI/180)       //analogous to x but use sin for y
+              * (1-curValue);
+
+            batch.Vertex(x, y);
+        }
+    }
+
+    batch.Vertex(FRAME_WIDTH/2 + radius*(1-wave[0][0]),
+                 FRAME_HEIGHT/2);                                       // reconnect to first point
+
+    batch.End();
+}
+
+//==============================================================================
+// 4. BLOB PLUS WAVE
+//==============================================================================
+
+const char* BlobPlusWave::GetName() const
+{
+    return "Blob plus Wave";
+}
+
+void BlobPlusWave::Load(Wave& song, int numSamples, bool precompute)
+// POST: The basic waveform's buffers have been made.
+{
+    wave.Load(song, numSamples, precompute);
+}
+
+void BlobPlusWave::Render(const FrameInfo& frame)
+// POST: The basic waveform has been drawn with the blob over it.
+{
+    wave.Render(frame);
+    blob.Render(frame);
+}
+
+//==============================================================================
+// 5. 3D CARPET
+//==============================================================================
+
+Carpet3D::Carpet3D()
+// POST: The carpet is facing the way it starts.
+{
+    Start();
+}
+
+const char* Carpet3D::GetName() const
+{
+    return "3D Carpet";
+}
+
+int Carpet3D::GetFlags() const
+{
+    return NEEDS_STEREO | THREE_D;                                  //the carpet runs from one channel to the next
+}
+
+void Carpet3D::Start()
+// POST: The carpet is facing the way it started.
+{
+    angle = 0;
+}
+
+void Carpet3D::Analyze(const FrameInfo& frame)
+// POST: The carpet has turned further the louder the frame is, by up to 60 degrees a second.
+{
+    angle += 60.0*frame.maxAmplitude*frame.advance/frame.wave->GetSampleRate();
+}
+
+void Carpet3D::Render(const FrameInfo& frame)
+// POST: A surface joining each channel's waveform to the next, one behind the other, has been drawn,
+//       turned by angle about the middle of the floor.
+{
+    Wave& wave = *frame.wave;
+    int numSamples = frame.numSamples;
+    VertexBatch& batch = *frame.batch;
+
+	glTranslatef(FRAME_WIDTH/2, 0, -FRAME_WIDTH*1.0*(wave.GetNumChannels()-1)/2.0);	//Translate the center of the "floor" from the origin
+	glRotatef(angle, 0.0, 1.0, 0.0);                                                    //Rotate about the y axis
+	glTranslatef(-FRAME_WIDTH/2, 0, FRAME_WIDTH*1.0*(wave.GetNumChannels()-1)/2.0);	//Translate the center of the "floor" to the origin
+                                                                                        //(note that matrix transformations are given in reverse)
+
+ 	double trapWidth = double(FRAME_WIDTH)/(numSamples-1);			 //The width of each trapezoid used for filling and
+                                                                     //  the horizontal spacing between samples.
+
+    batch.LineWidth(2.0);                                            //set line width to 2 pixels
+    batch.Color(frame.red, frame.green, frame.blue, 0.5);            //set fill color lighter than line color
+
+    // draw a surface by directly connecting each sample of the nth channel to the corresponding sample on the (n+1)th
+    // channel. Running a triangle strip back and forth between the two channels gives a "rectangle" (comprised of two
+    // triangles) between consecutive samples on each channel.
+    for (int n=0; n < wave.GetNumChannels()-1; n++)			    //loop through each channel that has a next channel...
+    {
+        batch.Begin(GL_TRIANGLE_STRIP);
+        for (int i=0; i < numSamples; i++)					    //...and every sample of that channel, connecting it
+        {                                                       //  to the corresponding sample on the next channel
+            batch.Vertex(i*trapWidth, WaveHeight(frame, n, i), -FRAME_WIDTH*n);
+            batch.Vertex(i*trapWidth, WaveHeight(frame, n+1, i), -FRAME_WIDTH*(n+1));
+        }
+        batch.End();
+    }
+}
+
+double Carpet3D::WaveHeight(const FrameInfo& frame, int n, int i) const
+//PRE: n < number of channels, i < frame.numSamples
+//POST: FCTVAL == the intended height of the wave at sample i of channel n of frame
+{
+	return (FRAME_HEIGHT/2*(1+(0.5+0.7*frame.maxAmplitude)*sin(2*M_PI*double(i)/frame.numSamples+frame.phaseShift)/2
+	        +(*frame.wave)[n][frame.sampleNumber+i]));
+}
+
+//==============================================================================
+// 6. 3D SURFACE
+//==============================================================================
+
+const char* Surface3D::GetName() const
+{
+    return "3D Surface";
+}
+
+int Surface3D::GetFlags() const
+{
+    return NEEDS_STEREO | THREE_D;                                  //rows from the left channel, columns from the right
+}
+
+void Surface3D::Create()
+// POST: The buffers the surface is drawn from have been created on the graphics card.
+{
+    surface.Create();
+}
+
+void Surface3D::Load(Wave&, int numSamples, bool)
+// POST: The grid and its triangles have been built for frames of numSamples samples, if they had not been.
+{
+    //draw a "surface" whose height is a function of the position on an imaginary FRAME_WIDTH*FRAME_WIDTH grid (with
+    // numSamples tickmarks) positioned in the positive-x, negative-y quadrant.
+    surface.Resize(numSamples, GLfloat(FRAME_WIDTH)/(numSamples-1)); //only rebuilt if numSamples changed
+    rows.resize(numSamples);
+    columns.resize(numSamples);
+}
+
+void Surface3D::Analyze(const FrameInfo& frame)
+// POST: rows and columns hold the frame's left and right channels, scaled to heights on the grid.
+{
+    // The height at any point on the grid corresponds to the sum of the left and right channel sample information,
+    // so the height at (i,j) is just a row term from sample i of the left channel plus a column term from sample j
+    // of the right channel.
+    for (int i=0; i < frame.numSamples; i++)
+    {
+        rows[i] = FRAME_HEIGHT*(0.2+(*frame.wave)[0][frame.sampleNumber+i]);
+        columns[i] = FRAME_HEIGHT*(*frame.wave)[1][frame.sampleNumber+i];
+    }
+}
+
+void Surface3D::Render(const FrameInfo& frame)
+// POST: A grid whose height at (i,j) is the left channel at sample i plus the right channel at
+//       sample j has been drawn in one draw call.
+{
+    glColor4f(frame.red, frame.green, frame.blue, 0.1);             //set fill color lighter than line color
+    surface.Draw(&rows[0], &columns[0]);                            //the whole grid in one draw call
+}
+
+//==============================================================================
+// 7. DFT
+//==============================================================================
+
+NoteSpectrum::NoteSpectrum()
+// POST: No song is loaded, so there is nothing to analyze yet.
+{
+    analyzer = NULL;
+    cache = NULL;
+    hopSize = 1;
+}
+
+NoteSpectrum::~NoteSpectrum()
+// POST: Any spectra still being precomputed are abandoned and their memory freed, along with the
+//       spectrum analyzer.
+{
+    delete cache;                                                   //stops the background thread
+    cache = NULL;
+    delete analyzer;
+    analyzer = NULL;
+}
+
+const char* NoteSpectrum::GetName() const
+{
+    return "DFT";
+}
+
+void NoteSpectrum::Load(Wave& song, int, bool precompute)
+// POST: The note kernels have been built for song's sample rate and, if precompute, the spectrum of
+//       every 1/SCROLL_RATE seconds of song is being computed in the background.
+{
+    delete cache;                                                   //stops the old song's background thread
+    cache = NULL;
+    delete analyzer;                                                //build the note kernels for this song's sample rate
+    analyzer = new ConstantQ(song.GetSampleRate(), DFT_LOW_OCTAVE, DFT_HIGH_OCTAVE, DFT_WINDOW);
+
+    hopSize = song.GetSampleRate()/SCROLL_RATE;
+    levels.resize(analyzer->GetNumBins());
+    scratch.resize(analyzer->GetFFTSize());
+
+    if (precompute)                                                 //begin precomputing spectra
+        cache = new SpectralCache(song, hopSize, *analyzer);
+}
+
+void NoteSpectrum::Analyze(const FrameInfo& frame)
+// POST: levels holds the level of each note at frame.sampleNumber, blended between the precomputed
+//       spectra either side of it if they are ready, otherwise computed here.
+{
+    double position = double(frame.sampleNumber)/hopSize;              //where we are, in precomputed frames
+    int index = int(position);                                          //precomputed frame at or before sampleNumber
+    double fraction = position-index;                                   //how far we are from it to the next one
+
+    if (cache && cache->Ready(index+1))                                 //look the spectrum up if the background
+    {                                                                   //  thread has gotten this far, blending the
+        const unsigned char* before = (*cache)[index];                  //  frames either side of sampleNumber so the
+        const unsigned char* after = (*cache)[index+1];                 //  bars move smoothly between them...
+        for (unsigned int i=0; i < levels.size(); i++)
+            levels[i] = before[i]+fraction*(after[i]-before[i]);
+    }
+    else                                                                //...otherwise take it ourselves
+        analyzer->Levels((*frame.wave)[0], frame.sampleNumber, scratch, &levels[0]);
+}
+
+void NoteSpectrum::Render(const FrameInfo& frame)
+// POST: Each note has been drawn as a bar as high as its level, lowest on the left.
+{
+    int numBins = levels.size();                                        //one bar per note
+    double barWidth = double(FRAME_WIDTH)/numBins;                      //width of each bar in pixels
+    VertexBatch& batch = *frame.batch;
+
+    batch.Color(frame.red, frame.green, frame.blue);
+
+    // Notes are spaced evenly across the window, lowest on the left, so each octave gets the same width.
+    batch.Begin(GL_QUADS);                                              //one bar per note bin
+    for (int i=0; i < numBins; i++)
+    {
+        batch.Vertex(i*barWidth+1, 0);                                  //leave a pixel between bars
+        batch.Vertex((i+1)*barWidth, 0);
+        batch.Vertex((i+1)*barWidth, levels[i]*FRAME_HEIGHT/255);
+        batch.Vertex(i*barWidth+1, levels[i]*FRAME_HEIGHT/255);
+    }
+    batch.End();
+}
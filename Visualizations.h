@@ -0,0 +1,155 @@
+// Visualizations: The visualizations GLWidget comes with, in the order they are numbered:
+//                 0: Basic Wave, 1: Wavy Oceany Type Thing, 2: Camel Parade, 3: Blob, 4: Blob plus Wave,
+//                 5: 3D Carpet, 6: 3D Surface, 7: DFT. Each draws ~256 samples (depending on sample rate),
+//                 0.005 seconds of audio, per frame.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <complex>
+#include <vector>
+#include "Visualization.h"
+#include "SurfaceMesh.h"
+#include "Wave/ConstantQ.h"
+#include "Wave/SpectralCache.h"
+using namespace std;
+
+const WindowType DFT_WINDOW = HANN;      //taper applied to each note kernel of the DFT visualization
+const int DFT_LOW_OCTAVE = 2;            //the DFT visualization shows notes from C in this octave...
+const int DFT_HIGH_OCTAVE = 7;           //...through B in this octave, one bar per note
+
+void LoadShaderSet(const FrameInfo& frame, vector<GLfloat>& samples, int set, int channel0, int channel1,
+                   bool reverse0);
+//PRE:  samples holds at least set+1 sets of 2*frame.numSamples values, channel0 and channel1 < number of channels
+//POST: Set set of samples holds the frame's samples of channel channel0 on edge 0 (last sample first if reverse0)
+//      and of channel channel1 on edge 1, ready for WaveShader::Upload.
+
+class BasicWave : public Visualization                                  //0. visualization of basic waveform
+{
+public:
+    const char* GetName() const;
+    void Load(Wave& song, int numSamples, bool precompute);
+    void Render(const FrameInfo& frame);
+    // POST: Each channel has been drawn as a waveform in its own band of the screen.
+
+private:
+    vector<GLfloat> shaderSamples;      //samples of the frame, as uploaded to the wave shader
+};
+
+class WavyOceanyTypeThing : public Visualization                        //1. "Wavy Oceany Type Thing" Visualization
+{
+public:
+    const char* GetName() const;
+    void Load(Wave& song, int numSamples, bool precompute);
+    void Render(const FrameInfo& frame);
+    // POST: The left channel has been drawn wrapped around a scrolling sine wave, filled in beneath.
+
+private:
+    vector<GLfloat> shaderSamples;      //samples of the frame, as uploaded to the wave shader
+    vector<GLfloat> height;             //height of the waveform at each sample, without the shader
+};
+
+class CamelParade : public Visualization                                //2. "Camel Parade" visualization
+{
+public:
+    const char* GetName() const;
+    int GetFlags() const;
+    void Load(Wave& song, int numSamples, bool precompute);
+    void Render(const FrameInfo& frame);
+    // POST: The left channel has been drawn around a scrolling sine wave at the top, the right channel
+    //       mirrored beneath it, and the area between them filled in.
+
+private:
+    vector<GLfloat> shaderSamples;      //samples of the frame, as uploaded to the wave shader
+    vector<GLfloat> top;                //height of the left channel at each sample, without the shader
+    vector<GLfloat> bottom;             //height of the right channel at each sample, without the shader
+};
+
+class Blob : public Visualization                                       //3. "blob" from AS3 visualizer
+{
+public:
+    const char* GetName() const;
+    void Render(const FrameInfo& frame);
+    // POST: Every channel has been drawn around a circle in the middle of the screen, filled in.
+};
+
+class BlobPlusWave : public Visualization                               //4. "blob" from AS3 visualizer + Basic Waveform
+{
+public:
+    const char* GetName() const;
+    void Load(Wave& song, int numSamples, bool precompute);
+    void Render(const FrameInfo& frame);
+    // POST: The basic waveform has been drawn with the blob over it.
+
+private:
+    BasicWave wave;
+    Blob blob;
+};
+
+class Carpet3D : public Visualization                                   //5. 3D Carpet
+{
+public:
+    Carpet3D();
+    // POST: The carpet is facing the way it starts.
+
+    const char* GetName() const;
+    int GetFlags() const;
+    void Start();
+    void Analyze(const FrameInfo& frame);
+    void Render(const FrameInfo& frame);
+    // POST: A surface joining each channel's waveform to the next, one behind the other, has been drawn,
+    //       turned by angle about the middle of the floor.
+
+private:
+    double angle;                       //degrees the carpet has turned about the y axis since Start
+
+    double WaveHeight(const FrameInfo& frame, int n, int i) const;
+    //PRE: n < number of channels, i < frame.numSamples
+    //POST: FCTVAL == the intended height of the wave at sample i of channel n of frame
+};
+
+class Surface3D : public Visualization                                  //6. 3D Surface
+{
+public:
+    const char* GetName() const;
+    int GetFlags() const;
+    void Create();
+    void Load(Wave& song, int numSamples, bool precompute);
+    void Analyze(const FrameInfo& frame);
+    void Render(const FrameInfo& frame);
+    // POST: A grid whose height at (i,j) is the left channel at sample i plus the right channel at
+    //       sample j has been drawn in one draw call.
+
+private:
+    SurfaceMesh surface;                //grid drawn, built once per song
+    vector<GLfloat> rows;               //height each row of surface gets from the left channel
+    vector<GLfloat> columns;            //height each column of surface gets from the right channel
+};
+
+class NoteSpectrum : public Visualization                               //7. DFT of the waveform
+{
+public:
+    NoteSpectrum();
+    // POST: No song is loaded, so there is nothing to analyze yet.
+
+    ~NoteSpectrum();
+    // POST: Any spectra still being precomputed are abandoned and their memory freed, along with the
+    //       spectrum analyzer.
+
+    const char* GetName() const;
+    void Load(Wave& song, int numSamples, bool precompute);
+    // POST: The note kernels have been built for song's sample rate and, if precompute, the spectrum of
+    //       every 1/SCROLL_RATE seconds of song is being computed in the background.
+    void Analyze(const FrameInfo& frame);
+    // POST: levels holds the level of each note at frame.sampleNumber, blended between the precomputed
+    //       spectra either side of it if they are ready, otherwise computed here.
+    void Render(const FrameInfo& frame);
+    // POST: Each note has been drawn as a bar as high as its level, lowest on the left.
+
+private:
+    ConstantQ* analyzer;                //note-by-note spectrum analyzer for the song's sample rate
+    SpectralCache* cache;               //spectra of the song, precomputed, or NULL if not
+    int hopSize;                        //samples between precomputed spectra
+    vector<unsigned char> levels;       //level of each note in the current frame, 0..255
+    vector<complex<double> > scratch;   //FFT buffer for computing levels
+};
@@ -0,0 +1,84 @@
+// ChannelMixer class: Mixes the channels of a Wave down (or up) to the number an audio device was opened
+//                     with. A mono song is sent to every output; otherwise input channel i goes to output
+//                     i modulo the number of outputs, except that on a stereo device the center channel of
+//                     a song that has one (the third of three channels, or of five or more) is shared
+//                     between left and right, and the LFE channel of a 5.1 or larger song is left out.
+//                     Quad songs (front left, front right, back left, back right) have no center.
+//                     Each output is scaled so the mix cannot be louder than its loudest input.
+
+#include "ChannelMixer.h"
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+ChannelMixer::ChannelMixer()
+// POST: A mixer from one channel to one channel
+{
+    inChannels = 0;                                         //so SetChannels has something to change
+    outChannels = 0;
+    SetChannels(1, 1);
+}
+
+void ChannelMixer::SetChannels(int inChannels, int outChannels)
+// PRE:  inChannels > 0, outChannels > 0
+// POST: The mixer takes inChannels channels to outChannels channels.
+{
+    double total;                                           //sum of the weights going into one output
+    bool hasCenter = inChannels == 3 || inChannels >= 5;    //channel 2 is center; in quad it is back left
+
+    if (inChannels == this->inChannels && outChannels == this->outChannels)
+        return;                                             //already set up
+
+    this->inChannels = inChannels;
+    this->outChannels = outChannels;
+    matrix.assign(outChannels*inChannels, 0.0);
+
+    for (int n=0; n < inChannels; n++)
+    {
+        if (inChannels == 1)                                //mono: the same in every output
+            for (int m=0; m < outChannels; m++)
+                matrix[m*inChannels] = 1.0;
+        else if (outChannels == 2 && hasCenter && n == 2)           //center, between left and right
+            matrix[n] = matrix[inChannels+n] = sqrt(0.5);
+        else if (outChannels == 2 && inChannels >= 6 && n == 3)     //LFE: too low to matter without a subwoofer
+            continue;
+        else
+            matrix[(n%outChannels)*inChannels + n] = 1.0;
+    }
+
+    for (int m=0; m < outChannels; m++)                     //no louder than the loudest input
+    {
+        total = 0.0;
+        for (int n=0; n < inChannels; n++)
+            total += matrix[m*inChannels+n];
+        if (total > 1.0)
+            for (int n=0; n < inChannels; n++)
+                matrix[m*inChannels+n] /= total;
+    }
+}
+
+void ChannelMixer::Process(Wave& wave, long first, long frames, double** output) const
+// PRE:  wave has inChannels channels, 0 <= first, first+frames <= wave.GetSamplesPerChannel(),
+//       output[0..outChannels-1] each have room for frames samples
+// POST: output[m][i] == frame first+i of wave mixed down to output channel m, for 0 <= i < frames
+{
+    double weight;
+
+    for (int m=0; m < outChannels; m++)
+    {
+        if (inChannels == outChannels)                      //nothing to mix: one channel straight across
+        {
+            copy(wave[m].begin()+first, wave[m].begin()+first+frames, output[m]);
+            continue;
+        }
+
+        fill(output[m], output[m]+frames, 0.0);
+        for (int n=0; n < inChannels; n++)
+        {
+            weight = matrix[m*inChannels+n];
+            if (weight != 0.0)
+                for (long i=0; i < frames; i++)
+                    output[m][i] += weight*wave[n][first+i];
+        }
+    }
+}
@@ -0,0 +1,33 @@
+// ChannelMixer class: Mixes the channels of a Wave down (or up) to the number an audio device was opened
+//                     with. A mono song is sent to every output; otherwise input channel i goes to output
+//                     i modulo the number of outputs, except that on a stereo device the center channel of
+//                     a song that has one (the third of three channels, or of five or more) is shared
+//                     between left and right, and the LFE channel of a 5.1 or larger song is left out.
+//                     Quad songs (front left, front right, back left, back right) have no center.
+//                     Each output is scaled so the mix cannot be louder than its loudest input.
+
+#pragma once
+#include <vector>
+#include "Wave.h"
+using namespace std;
+
+class ChannelMixer
+{
+public:
+    ChannelMixer();
+    // POST: A mixer from one channel to one channel
+
+    void SetChannels(int inChannels, int outChannels);
+    // PRE:  inChannels > 0, outChannels > 0
+    // POST: The mixer takes inChannels channels to outChannels channels.
+
+    void Process(Wave& wave, long first, long frames, double** output) const;
+    // PRE:  wave has inChannels channels, 0 <= first, first+frames <= wave.GetSamplesPerChannel(),
+    //       output[0..outChannels-1] each have room for frames samples
+    // POST: output[m][i] == frame first+i of wave mixed down to output channel m, for 0 <= i < frames
+
+private:
+    int inChannels;                         //number of channels mixed from and to
+    int outChannels;
+    vector<double> matrix;                  //weight of input channel n in output m, at m*inChannels+n
+};
@@ -0,0 +1,134 @@
+// ConstantQ class: Constant-Q spectrum analyzer with one bin per semitone. Every bin is centered on
+//                  a musical note (see NoteType::Frequency) and is as wide as the gap between
+//                  neighbouring notes, so low notes get as much resolution as high ones. Each bin's
+//                  analysis kernel is transformed once, when the analyzer is built, and only its
+//                  significant coefficients are kept; a frame then costs one FFT plus a short sparse
+//                  sum per bin.
+//                  (Method: J. Brown and M. Puckette, "An efficient algorithm for the calculation of a
+//                  constant Q transform", JASA 92(5), 1992.)
+
+#include "ConstantQ.h"
+#include "NoteType.h"
+#include "Utility.h"
+#include <math.h>
+using namespace std;
+
+const double ConstantQ::SPECTRAL_RANGE = 60;
+const double ConstantQ::KERNEL_THRESHOLD = 0.0054;
+
+ConstantQ::ConstantQ(int sampleRate, int lowOctave, int highOctave, WindowType window)
+// PRE:  sampleRate > 0, 0 < lowOctave <= highOctave, Assigned(window)
+// POST: The analyzer has one bin for every note from C in octave lowOctave through B in octave
+//         highOctave, dropping any note at or above half of sampleRate. Each bin's kernel is
+//         tapered by window. If no note is below half of sampleRate, it has no bins.
+{
+    double q = 1/(pow(2, 1/12.0)-1);        //ratio of each bin's frequency to its width: one semitone
+
+    for (int octave=lowOctave; octave <= highOctave; octave++)
+        for (int note=C; note <= B; note++)
+            if (NoteType::Frequency(Note(note), octave) < sampleRate/2.0)
+                frequencies.push_back(NoteType::Frequency(Note(note), octave));
+
+    fftSize = 1;
+    kernelStart.push_back(0);
+    if (frequencies.empty())                //sampleRate too low for any note asked for
+        return;
+
+    while (fftSize < q*sampleRate/frequencies[0])   //the lowest note needs the longest kernel: q periods of it
+        fftSize *= 2;
+
+    vector<complex<double> > kernel(fftSize);  //one bin's kernel, in time and then in frequency
+
+    for (unsigned int k=0; k < frequencies.size(); k++)
+    {
+        int length = int(ceil(q*sampleRate/frequencies[k]));     //kernel length for this bin, in samples
+        int offset = (fftSize-length)/2;                        //centers every kernel in the frame
+        const vector<double>& taper = Window::Table(window, length);
+
+        // The time kernel is a tapered complex sinusoid at the note's frequency. Its spectrum is
+        // concentrated around the note, so all but a few coefficients can be dropped.
+        for (int i=0; i < fftSize; i++)
+            kernel[i] = 0;
+        for (int i=0; i < length; i++)
+            kernel[offset+i] = polar(taper[i]/length, 2*M_PI*frequencies[k]*i/sampleRate);
+
+        Utility::FFTInPlace(kernel);
+
+        for (int i=0; i < fftSize; i++)
+            if (abs(kernel[i]) > KERNEL_THRESHOLD)
+            {
+                kernelIndex.push_back(i);
+                kernelValues.push_back(conj(kernel[i])/double(fftSize));
+            }
+        kernelStart.push_back(kernelIndex.size());
+    }
+}
+
+void ConstantQ::Transform(const vector<double>& signal, long center, vector<complex<double> >& scratch,
+                          vector<double>& magnitudes) const
+// PRE:  scratch.size() == GetFFTSize(), magnitudes.size() == GetNumBins()
+// POST: magnitudes[k] holds the strength of note bin k in the GetFFTSize() samples of signal centered
+//         on sample center. Samples before the start or past the end of signal are taken as silence.
+{
+    long start = center-fftSize/2;          //first sample of the frame
+
+    for (int i=0; i < fftSize; i++)
+        scratch[i] = start+i >= 0 && start+i < long(signal.size()) ? signal[start+i] : 0.0;
+
+    Utility::FFTInPlace(scratch);
+
+    for (unsigned int k=0; k < frequencies.size(); k++)
+    {
+        complex<double> sum = 0;            //the frame's spectrum weighted by the bin's kernel
+
+        for (int j=kernelStart[k]; j < kernelStart[k+1]; j++)
+            sum += scratch[kernelIndex[j]]*kernelValues[j];
+
+        magnitudes[k] = abs(sum);
+    }
+}
+
+void ConstantQ::Levels(const vector<double>& signal, long center, vector<complex<double> >& scratch,
+                       unsigned char levels[]) const
+// PRE:  scratch.size() == GetFFTSize(), levels holds GetNumBins() entries
+// POST: levels[k] holds the strength of note bin k, as for Transform, in decibels below the loudest
+//         bin of the frame, scaled so 255 is the loudest bin and 0 is SPECTRAL_RANGE decibels (or
+//         more) below it.
+{
+    vector<double> magnitudes(frequencies.size());
+    double max = 0;                         //loudest bin of the frame
+    double level;                           //one bin's level, from 0 to 1
+
+    Transform(signal, center, scratch, magnitudes);
+
+    for (unsigned int k=0; k < magnitudes.size(); k++)
+        if (magnitudes[k] > max)
+            max = magnitudes[k];
+
+    for (unsigned int k=0; k < magnitudes.size(); k++)
+    {
+        level = max > 0 && magnitudes[k] > 0
+              ? 1+20*log10(magnitudes[k]/max)/SPECTRAL_RANGE
+              : 0;
+        levels[k] = level > 0 ? (unsigned char)(255*level) : 0;
+    }
+}
+
+int ConstantQ::GetNumBins() const
+// POST: FCTVAL == the number of note bins
+{
+    return frequencies.size();
+}
+
+int ConstantQ::GetFFTSize() const
+// POST: FCTVAL == the number of samples in each frame, a power of 2 long enough for the lowest note
+{
+    return fftSize;
+}
+
+double ConstantQ::BinFrequency(int bin) const
+// PRE:  0 <= bin < GetNumBins()
+// POST: FCTVAL == the frequency in Hz of the note bin bin is centered on
+{
+    return frequencies[bin];
+}
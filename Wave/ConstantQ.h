@@ -0,0 +1,60 @@
+// ConstantQ class: Constant-Q spectrum analyzer with one bin per semitone. Every bin is centered on
+//                  a musical note (see NoteType::Frequency) and is as wide as the gap between
+//                  neighbouring notes, so low notes get as much resolution as high ones. Each bin's
+//                  analysis kernel is transformed once, when the analyzer is built, and only its
+//                  significant coefficients are kept; a frame then costs one FFT plus a short sparse
+//                  sum per bin.
+//                  (Method: J. Brown and M. Puckette, "An efficient algorithm for the calculation of a
+//                  constant Q transform", JASA 92(5), 1992.)
+
+#pragma once
+#include <vector>
+#include <complex>
+#include "Window.h"
+using namespace std;
+
+class ConstantQ
+{
+public:
+    ConstantQ(int sampleRate, int lowOctave = 2, int highOctave = 7, WindowType window = HANN);
+    // PRE:  sampleRate > 0, 0 < lowOctave <= highOctave, Assigned(window)
+    // POST: The analyzer has one bin for every note from C in octave lowOctave through B in octave
+    //         highOctave, dropping any note at or above half of sampleRate. Each bin's kernel is
+    //         tapered by window. If no note is below half of sampleRate, it has no bins.
+
+    void Transform(const vector<double>& signal, long center, vector<complex<double> >& scratch,
+                   vector<double>& magnitudes) const;
+    // PRE:  scratch.size() == GetFFTSize(), magnitudes.size() == GetNumBins()
+    // POST: magnitudes[k] holds the strength of note bin k in the GetFFTSize() samples of signal centered
+    //         on sample center. Samples before the start or past the end of signal are taken as silence.
+
+    void Levels(const vector<double>& signal, long center, vector<complex<double> >& scratch,
+                unsigned char levels[]) const;
+    // PRE:  scratch.size() == GetFFTSize(), levels holds GetNumBins() entries
+    // POST: levels[k] holds the strength of note bin k, as for Transform, in decibels below the loudest
+    //         bin of the frame, scaled so 255 is the loudest bin and 0 is SPECTRAL_RANGE decibels (or
+    //         more) below it.
+
+    int GetNumBins() const;
+    // POST: FCTVAL == the number of note bins
+
+    int GetFFTSize() const;
+    // POST: FCTVAL == the number of samples in each frame, a power of 2 long enough for the lowest note
+
+    double BinFrequency(int bin) const;
+    // PRE:  0 <= bin < GetNumBins()
+    // POST: FCTVAL == the frequency in Hz of the note bin bin is centered on
+
+    static const double SPECTRAL_RANGE;     //decibels between the loudest and quietest level reported
+    static const double KERNEL_THRESHOLD;   //kernel coefficients smaller than this are dropped
+
+private:
+    int fftSize;                            //samples per frame
+    vector<double> frequencies;             //center frequency of each bin, in Hz
+
+    // The kernels are stored one after another: the coefficients of bin k are kernelValues[j] for
+    //   kernelStart[k] <= j < kernelStart[k+1], each applying to FFT bin kernelIndex[j].
+    vector<int> kernelStart;
+    vector<int> kernelIndex;
+    vector<complex<double> > kernelValues;
+};
@@ -0,0 +1,168 @@
+// Convolver class: Effect that convolves audio with an impulse response (an FIR filter, the echo of
+//                  a room...) using uniformly partitioned overlap-save FFT convolution. The impulse is
+//                  cut into partitions of partitionSize samples, each kept as a spectrum; every time a
+//                  partition's worth of input has arrived it is transformed once and multiplied against
+//                  all partition spectra, so the cost per sample grows with log(partitionSize) and the
+//                  number of partitions instead of the length of the impulse. Small partitions give low
+//                  latency for live use; one large partition is cheapest for offline processing.
+
+#include "Convolver.h"
+#include "Utility.h"
+using namespace std;
+
+const int Convolver::MAX_OFFLINE_PARTITION = 65536;
+
+Convolver::Convolver(const vector<double>& impulse, int partitionSize)
+// PRE:  impulse is not empty, partitionSize is a power of 2
+// POST: Every channel passed to Process will be convolved with impulse, with a latency of
+//         partitionSize frames.
+{
+    Init(vector<vector<double> >(1, impulse), partitionSize);
+}
+
+Convolver::Convolver(const vector<vector<double> >& impulses, int partitionSize)
+// PRE:  impulses is not empty and none of its members are empty, partitionSize is a power of 2
+// POST: Channel n passed to Process will be convolved with impulses[n % impulses.size()] (e.g. the
+//         left and right responses of a stereo reverb), with a latency of partitionSize frames.
+{
+    Init(impulses, partitionSize);
+}
+
+void Convolver::Process(double** block, int numChannels, int numFrames)
+// PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+// POST: Every block[n] has been replaced by the convolution of the stream so far with its impulse,
+//         delayed by GetLatency() frames.
+{
+    if (int(channels.size()) != numChannels)        //first call, or the channel count changed:
+    {                                               //  start every channel from silence
+        channels.resize(numChannels);
+        Reset();
+    }
+
+    for (int done=0; done < numFrames; )            //take the block in pieces that end at partition boundaries
+    {
+        int count = numFrames-done < partitionSize-filled ? numFrames-done : partitionSize-filled;
+
+        for (int n=0; n < numChannels; n++)         //swap the new input for output computed a partition ago
+            for (int i=0; i < count; i++)
+            {
+                channels[n].input[partitionSize+filled+i] = block[n][done+i];
+                block[n][done+i] = channels[n].output[filled+i];
+            }
+
+        filled += count;
+        done += count;
+
+        if (filled == partitionSize)                //a whole partition is in: compute the next one's output
+        {
+            for (int n=0; n < numChannels; n++)
+                ConvolvePartition(channels[n], filters[n % filters.size()]);
+            filled = 0;
+        }
+    }
+}
+
+void Convolver::Reset()
+// POST: All buffered input and output has been cleared.
+{
+    filled = 0;
+
+    for (unsigned int n=0; n < channels.size(); n++)
+    {
+        channels[n].input.assign(2*partitionSize, 0.0);
+        channels[n].output.assign(partitionSize, 0.0);
+        channels[n].history.assign(numPartitions, vector<complex<double> >(2*partitionSize));
+        channels[n].newest = 0;
+    }
+}
+
+int Convolver::GetLatency() const
+// POST: FCTVAL == partitionSize
+{
+    return partitionSize;
+}
+
+int Convolver::OfflinePartitionSize(long impulseLength)
+// PRE:  impulseLength > 0
+// POST: FCTVAL == a partition size suited to processing a whole Wave at once: the impulse in as few
+//                 partitions as possible without letting a single transform grow unreasonably large
+{
+    int size = 256;                                 //smaller partitions gain nothing offline
+
+    while (size < impulseLength && size < MAX_OFFLINE_PARTITION)
+        size *= 2;
+
+    return size;
+}
+
+void Convolver::Init(const vector<vector<double> >& impulses, int partitionSize)
+// PRE:  impulses is not empty and none of its members are empty, partitionSize is a power of 2
+// POST: filters holds the partition spectra of every impulse, and the object is Reset()
+{
+    this->partitionSize = partitionSize;
+    numPartitions = 0;
+
+    for (unsigned int k=0; k < impulses.size(); k++)    //enough partitions to hold the longest impulse
+        if (int((impulses[k].size()+partitionSize-1)/partitionSize) > numPartitions)
+            numPartitions = (impulses[k].size()+partitionSize-1)/partitionSize;
+
+    // Each partition is zero-padded to twice its length before transforming, so that multiplying
+    // spectra gives a linear (not circular) convolution in the half of the output we keep.
+    filters.assign(impulses.size(), vector<vector<complex<double> > >(numPartitions));
+    for (unsigned int k=0; k < impulses.size(); k++)
+        for (int p=0; p < numPartitions; p++)
+        {
+            vector<complex<double> >& spectrum = filters[k][p];
+            spectrum.assign(2*partitionSize, 0.0);
+
+            for (long i=0; i < partitionSize && long(p)*partitionSize+i < long(impulses[k].size()); i++)
+                spectrum[i] = impulses[k][long(p)*partitionSize+i];
+
+            Utility::FFTInPlace(spectrum);
+        }
+
+    scratch.resize(2*partitionSize);
+    accumulator.resize(2*partitionSize);
+    channels.clear();
+    Reset();
+}
+
+void Convolver::ConvolvePartition(ChannelState& state, const vector<vector<complex<double> > >& filter)
+// PRE:  state.input holds two full partitions of input
+// POST: state.output holds the next partitionSize samples of output, and state.input has been
+//         shifted down by one partition to make room for the next
+{
+    int size = 2*partitionSize;                     //transform length
+
+    for (int i=0; i < size; i++)
+        scratch[i] = state.input[i];
+    Utility::FFTInPlace(scratch);
+
+    state.newest = (state.newest+1) % numPartitions;    //the oldest spectrum is no longer needed
+    state.history[state.newest].swap(scratch);
+
+    // Partition p of the impulse lines up with the input spectrum from p partitions ago. The input and
+    // impulse are real, so only bins up to Nyquist need multiplying; the rest are their mirror images.
+    for (int bin=0; bin <= partitionSize; bin++)
+        accumulator[bin] = 0;
+
+    for (int p=0; p < int(filter.size()); p++)
+    {
+        const vector<complex<double> >& input = state.history[(state.newest-p+numPartitions) % numPartitions];
+        const vector<complex<double> >& impulse = filter[p];
+
+        for (int bin=0; bin <= partitionSize; bin++)
+            accumulator[bin] += input[bin]*impulse[bin];
+    }
+
+    for (int bin=1; bin < partitionSize; bin++)
+        accumulator[size-bin] = conj(accumulator[bin]);
+
+    Utility::IFFTInPlace(accumulator);
+
+    for (int i=0; i < partitionSize; i++)           //the first half wrapped around; the second half is
+        state.output[i] = accumulator[partitionSize+i].real();  //  the true output for the newest partition
+
+    for (int i=0; i < partitionSize; i++)           //the newest partition becomes the previous one
+        state.input[i] = state.input[partitionSize+i];
+}
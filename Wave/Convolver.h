@@ -0,0 +1,72 @@
+// Convolver class: Effect that convolves audio with an impulse response (an FIR filter, the echo of
+//                  a room...) using uniformly partitioned overlap-save FFT convolution. The impulse is
+//                  cut into partitions of partitionSize samples, each kept as a spectrum; every time a
+//                  partition's worth of input has arrived it is transformed once and multiplied against
+//                  all partition spectra, so the cost per sample grows with log(partitionSize) and the
+//                  number of partitions instead of the length of the impulse. Small partitions give low
+//                  latency for live use; one large partition is cheapest for offline processing.
+
+#pragma once
+#include <vector>
+#include <complex>
+#include "Effect.h"
+using namespace std;
+
+class Convolver : public Effect
+{
+public:
+    Convolver(const vector<double>& impulse, int partitionSize = 256);
+    // PRE:  impulse is not empty, partitionSize is a power of 2
+    // POST: Every channel passed to Process will be convolved with impulse, with a latency of
+    //         partitionSize frames.
+
+    Convolver(const vector<vector<double> >& impulses, int partitionSize = 256);
+    // PRE:  impulses is not empty and none of its members are empty, partitionSize is a power of 2
+    // POST: Channel n passed to Process will be convolved with impulses[n % impulses.size()] (e.g. the
+    //         left and right responses of a stereo reverb), with a latency of partitionSize frames.
+
+    void Process(double** block, int numChannels, int numFrames);
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every block[n] has been replaced by the convolution of the stream so far with its impulse,
+    //         delayed by GetLatency() frames.
+
+    void Reset();
+    // POST: All buffered input and output has been cleared.
+
+    int GetLatency() const;
+    // POST: FCTVAL == partitionSize
+
+    static int OfflinePartitionSize(long impulseLength);
+    // PRE:  impulseLength > 0
+    // POST: FCTVAL == a partition size suited to processing a whole Wave at once: the impulse in as few
+    //                 partitions as possible without letting a single transform grow unreasonably large
+
+    static const int MAX_OFFLINE_PARTITION;     //largest partition OfflinePartitionSize will suggest
+
+private:
+    class ChannelState
+    {
+    public:
+        vector<double> input;                   //the previous partition of input followed by the current one
+        vector<double> output;                  //the most recently computed partition of output
+        vector<vector<complex<double> > > history;  //spectra of the last numPartitions input windows
+        int newest;                             //index in history of the most recent spectrum
+    };
+
+    void Init(const vector<vector<double> >& impulses, int partitionSize);
+    // PRE:  impulses is not empty and none of its members are empty, partitionSize is a power of 2
+    // POST: filters holds the partition spectra of every impulse, and the object is Reset()
+
+    void ConvolvePartition(ChannelState& state, const vector<vector<complex<double> > >& filter);
+    // PRE:  state.input holds two full partitions of input
+    // POST: state.output holds the next partitionSize samples of output, and state.input has been
+    //         shifted down by one partition to make room for the next
+
+    int partitionSize;                          //samples per partition, and the latency of the effect
+    int numPartitions;                          //partitions in the longest impulse
+    int filled;                                 //samples of the current partition received so far
+    vector<vector<vector<complex<double> > > > filters;     //spectrum of each partition of each impulse
+    vector<ChannelState> channels;              //running state for each channel being processed
+    vector<complex<double> > scratch;           //transform buffer, 2*partitionSize long
+    vector<complex<double> > accumulator;       //sum of products of input and impulse spectra
+};
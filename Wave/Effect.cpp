@@ -0,0 +1,61 @@
+// Effect class: Base class for anything that alters audio a block at a time. An effect is fed
+//               consecutive blocks of samples, one buffer per channel, and rewrites each block in
+//               place, carrying whatever history it needs from one block to the next. The same
+//               effect can therefore run over a whole Wave offline or on small blocks during playback.
+
+#include "Effect.h"
+#include "Wave.h"
+#include "Utility.h"
+#include <vector>
+#include <iostream>
+using namespace std;
+
+Effect::~Effect()
+// POST: Object is completely removed from virtual memory
+{
+}
+
+void Effect::Reset()
+// POST: All history has been cleared, as if the effect had never been fed any samples.
+{
+}
+
+int Effect::GetLatency() const
+// POST: FCTVAL == the number of frames by which the output of Process lags its input
+{
+    return 0;
+}
+
+void Effect::Apply(Wave& wave, int blockSize)
+// PRE:  wave is initialized, blockSize > 0
+// POST: Every channel of wave has been run through the effect, blockSize frames at a time, and
+//         shifted back by GetLatency() frames so that the output lines up with the input. The length
+//         of wave is unchanged. The effect is Reset() before starting.
+{
+    int numChannels = wave.GetNumChannels();
+    long length = wave.GetSamplesPerChannel();
+    int latency = GetLatency();                         //frames of silence to push through after the wave
+    long total = length+latency;                        //  so that its last samples come back out
+    vector<double*> block(numChannels);                 //where each channel's current block starts
+
+    Reset();
+
+    for (int n=0; n < numChannels; n++)
+        wave[n].resize(total, 0.0);
+
+    for (long start=0; start < total; start += blockSize)
+    {
+        Utility::Bar(cout, start, total);               //Display friendly progress bar
+
+        for (int n=0; n < numChannels; n++)
+            block[n] = &wave[n][start];
+
+        Process(&block[0], numChannels, start+blockSize < total ? blockSize : total-start);
+    }
+
+    Utility::Bar(cout, total, total);
+    cout << endl;
+
+    for (int n=0; n < numChannels; n++)                 //drop the latency from the front, leaving
+        wave[n].erase(wave[n].begin(), wave[n].begin()+latency);    //  length samples
+}
@@ -0,0 +1,33 @@
+// Effect class: Base class for anything that alters audio a block at a time. An effect is fed
+//               consecutive blocks of samples, one buffer per channel, and rewrites each block in
+//               place, carrying whatever history it needs from one block to the next. The same
+//               effect can therefore run over a whole Wave offline or on small blocks during playback.
+
+#pragma once
+using namespace std;
+
+class Wave;
+
+class Effect
+{
+public:
+    virtual ~Effect();
+    // POST: Object is completely removed from virtual memory
+
+    virtual void Process(double** block, int numChannels, int numFrames) = 0;
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every block[n] has been replaced by the effect's output for those samples. The block
+    //         continues the stream from the previous call, so successive calls may use any block size.
+
+    virtual void Reset();
+    // POST: All history has been cleared, as if the effect had never been fed any samples.
+
+    virtual int GetLatency() const;
+    // POST: FCTVAL == the number of frames by which the output of Process lags its input
+
+    void Apply(Wave& wave, int blockSize = 4096);
+    // PRE:  wave is initialized, blockSize > 0
+    // POST: Every channel of wave has been run through the effect, blockSize frames at a time, and
+    //         shifted back by GetLatency() frames so that the output lines up with the input. The length
+    //         of wave is unchanged. The effect is Reset() before starting.
+};
@@ -0,0 +1,108 @@
+// EffectChain class: Effect made of other effects run one after another on the same block, so a whole
+//                    chain (gain, EQ, pitch...) can be applied wherever a single effect can. Also holds
+//                    Gain, the simplest effect, whose level can be changed while audio is playing.
+
+#include "EffectChain.h"
+#include <math.h>
+using namespace std;
+
+EffectChain::~EffectChain()
+// POST: Every effect added has been deleted.
+{
+    for (unsigned int i=0; i < effects.size(); i++)
+        delete effects[i];
+}
+
+void EffectChain::Add(Effect* effect)
+// PRE:  effect was allocated with new, Process is not running on another thread
+// POST: effect runs last in the chain, numbered GetCount()-1, and is owned by the chain.
+{
+    effects.push_back(effect);
+}
+
+int EffectChain::GetCount() const
+// POST: FCTVAL == the number of effects added
+{
+    return effects.size();
+}
+
+Effect& EffectChain::operator [](int i) const
+// PRE:  0 <= i < GetCount()
+// POST: FCTVAL == effect number i
+{
+    return *effects[i];
+}
+
+void EffectChain::Process(double** block, int numChannels, int numFrames)
+// PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+// POST: Every block[n] has been run through each effect in the order they were added.
+{
+    for (unsigned int i=0; i < effects.size(); i++)
+        effects[i]->Process(block, numChannels, numFrames);
+}
+
+void EffectChain::Reset()
+// POST: Every effect in the chain has been Reset().
+{
+    for (unsigned int i=0; i < effects.size(); i++)
+        effects[i]->Reset();
+}
+
+int EffectChain::GetLatency() const
+// POST: FCTVAL == the sum of the latencies of the effects in the chain
+{
+    int latency = 0;
+
+    for (unsigned int i=0; i < effects.size(); i++)
+        latency += effects[i]->GetLatency();
+
+    return latency;
+}
+
+Gain::Gain(double decibels)
+// POST: Samples passed to Process will be scaled by decibels dB.
+{
+    this->decibels = decibels;
+    Reset();
+}
+
+void Gain::SetGain(double decibels)
+// POST: Over the next block passed to Process, the gain moves smoothly to decibels dB, so the change
+//         does not click. Safe to call from any thread while Process runs on another.
+{
+    this->decibels = decibels;
+}
+
+double Gain::GetGain() const
+// POST: FCTVAL == the gain last set, in dB
+{
+    return decibels;
+}
+
+void Gain::Process(double** block, int numChannels, int numFrames)
+// PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+// POST: Every sample of block has been scaled by the gain, ramping from the last block's gain to
+//         the one set since.
+{
+    double target = pow(10.0, decibels/20);             //factor to end the block on
+    double step;                                        //change in factor from one frame to the next
+
+    if (numFrames == 0)
+        return;
+
+    if (target == 1.0 && current == 1.0)                //nothing to do at unity gain
+        return;
+
+    step = (target-current)/numFrames;
+    for (int n=0; n < numChannels; n++)
+        for (int i=0; i < numFrames; i++)
+            block[n][i] *= current + step*(i+1);
+
+    current = target;
+}
+
+void Gain::Reset()
+// POST: The gain jumps straight to the one last set.
+{
+    current = pow(10.0, decibels/20);
+}
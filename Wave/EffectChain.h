@@ -0,0 +1,66 @@
+// EffectChain class: Effect made of other effects run one after another on the same block, so a whole
+//                    chain (gain, EQ, pitch...) can be applied wherever a single effect can. Also holds
+//                    Gain, the simplest effect, whose level can be changed while audio is playing.
+
+#pragma once
+#include <vector>
+#include <atomic>
+#include "Effect.h"
+using namespace std;
+
+class EffectChain : public Effect
+{
+public:
+    ~EffectChain();
+    // POST: Every effect added has been deleted.
+
+    void Add(Effect* effect);
+    // PRE:  effect was allocated with new, Process is not running on another thread
+    // POST: effect runs last in the chain, numbered GetCount()-1, and is owned by the chain.
+
+    int GetCount() const;
+    // POST: FCTVAL == the number of effects added
+
+    Effect& operator [](int i) const;
+    // PRE:  0 <= i < GetCount()
+    // POST: FCTVAL == effect number i
+
+    void Process(double** block, int numChannels, int numFrames);
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every block[n] has been run through each effect in the order they were added.
+
+    void Reset();
+    // POST: Every effect in the chain has been Reset().
+
+    int GetLatency() const;
+    // POST: FCTVAL == the sum of the latencies of the effects in the chain
+
+private:
+    vector<Effect*> effects;                //in the order they run
+};
+
+class Gain : public Effect
+{
+public:
+    Gain(double decibels = 0.0);
+    // POST: Samples passed to Process will be scaled by decibels dB.
+
+    void SetGain(double decibels);
+    // POST: Over the next block passed to Process, the gain moves smoothly to decibels dB, so the change
+    //         does not click. Safe to call from any thread while Process runs on another.
+
+    double GetGain() const;
+    // POST: FCTVAL == the gain last set, in dB
+
+    void Process(double** block, int numChannels, int numFrames);
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every sample of block has been scaled by the gain, ramping from the last block's gain to
+    //         the one set since.
+
+    void Reset();
+    // POST: The gain jumps straight to the one last set.
+
+private:
+    atomic<double> decibels;                //gain asked for
+    double current;                         //factor applied at the end of the last block
+};
@@ -0,0 +1,133 @@
+// Equalizer class: Three-band equalizer for live playback: a low shelf, a peak in the middle and a high
+//                  shelf, each a biquad filter (from Robert Bristow-Johnson's Audio EQ Cookbook) whose
+//                  gain can be turned up or down while audio is playing. Cheap enough to run on small
+//                  blocks in real time, with no latency.
+
+#include "Equalizer.h"
+#include <math.h>
+using namespace std;
+
+Equalizer::Equalizer(int sampleRate)
+// PRE:  sampleRate > 2*EQ_FREQUENCIES[EQ_BANDS-1]
+// POST: A flat equalizer for audio sampled at sampleRate
+{
+    for (int band=0; band < EQ_BANDS; band++)
+        gains[band] = 0.0;
+    SetSampleRate(sampleRate);
+}
+
+void Equalizer::SetSampleRate(int sampleRate)
+// PRE:  sampleRate > 2*EQ_FREQUENCIES[EQ_BANDS-1], Process is not running on another thread
+// POST: The filters have been redesigned for audio sampled at sampleRate, and the equalizer is Reset().
+{
+    this->sampleRate = sampleRate;
+    for (int band=0; band < EQ_BANDS; band++)
+        Design(band, gains[band]);
+    Reset();
+}
+
+void Equalizer::SetBand(int band, double decibels)
+// PRE:  0 <= band < EQ_BANDS
+// POST: From the next block passed to Process on, band band is boosted by decibels dB (cut if
+//         negative). Safe to call from any thread while Process runs on another.
+{
+    gains[band] = decibels;
+}
+
+double Equalizer::GetBand(int band) const
+// PRE:  0 <= band < EQ_BANDS
+// POST: FCTVAL == the gain of band band last set, in dB
+{
+    return gains[band];
+}
+
+void Equalizer::Process(double** block, int numChannels, int numFrames)
+// PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+// POST: Every block[n] has been filtered by each band in turn.
+{
+    double x;                                           //input and output of a filter for one sample
+    double y;
+
+    if (int(history.size()) < 2*EQ_BANDS*numChannels)   //more channels than before
+        history.resize(2*EQ_BANDS*numChannels, 0.0);
+
+    for (int band=0; band < EQ_BANDS; band++)
+    {
+        if (gains[band] != designed[band])              //turned up or down since the last block
+            Design(band, gains[band]);
+        if (designed[band] == 0.0)                      //a flat band leaves the samples alone
+            continue;
+
+        const Biquad& f = filters[band];
+        for (int n=0; n < numChannels; n++)
+        {
+            double& z1 = history[2*(EQ_BANDS*n + band)];    //state of the filter for this channel,
+            double& z2 = history[2*(EQ_BANDS*n + band) + 1];//  transposed direct form II
+
+            for (int i=0; i < numFrames; i++)
+            {
+                x = block[n][i];
+                y = f.b0*x + z1;
+                z1 = f.b1*x - f.a1*y + z2;
+                z2 = f.b2*x - f.a2*y;
+                block[n][i] = y;
+            }
+        }
+    }
+}
+
+void Equalizer::Reset()
+// POST: The filters' history has been cleared.
+{
+    history.assign(history.size(), 0.0);
+}
+
+void Equalizer::Design(int band, double decibels)
+// PRE:  0 <= band < EQ_BANDS
+// POST: filters[band] boosts its band by decibels dB at sampleRate, and designed[band] == decibels
+{
+    double A = pow(10.0, decibels/40);                  //square root of the gain
+    double w0 = 2*M_PI*EQ_FREQUENCIES[band]/sampleRate; //center frequency, in radians per sample
+    double cosw = cos(w0);
+    double alpha;                                       //bandwidth term
+    double a0;                                          //leading denominator coefficient, divided out
+    Biquad& f = filters[band];
+
+    if (band == 0)                                      //low shelf, slope 1
+    {
+        alpha = sin(w0)/2*sqrt(2.0);
+        a0   =          (A+1) + (A-1)*cosw + 2*sqrt(A)*alpha;
+        f.b0 =    A*(   (A+1) - (A-1)*cosw + 2*sqrt(A)*alpha);
+        f.b1 =  2*A*(   (A-1) - (A+1)*cosw                  );
+        f.b2 =    A*(   (A+1) - (A-1)*cosw - 2*sqrt(A)*alpha);
+        f.a1 =   -2*(   (A-1) + (A+1)*cosw                  );
+        f.a2 =          (A+1) + (A-1)*cosw - 2*sqrt(A)*alpha;
+    }
+    else if (band == EQ_BANDS-1)                        //high shelf, slope 1
+    {
+        alpha = sin(w0)/2*sqrt(2.0);
+        a0   =          (A+1) - (A-1)*cosw + 2*sqrt(A)*alpha;
+        f.b0 =    A*(   (A+1) + (A-1)*cosw + 2*sqrt(A)*alpha);
+        f.b1 = -2*A*(   (A-1) + (A+1)*cosw                  );
+        f.b2 =    A*(   (A+1) + (A-1)*cosw - 2*sqrt(A)*alpha);
+        f.a1 =    2*(   (A-1) - (A+1)*cosw                  );
+        f.a2 =          (A+1) - (A-1)*cosw - 2*sqrt(A)*alpha;
+    }
+    else                                                //peak, one octave wide
+    {
+        alpha = sin(w0)*sinh(log(2.0)/2*w0/sin(w0));
+        a0   = 1 + alpha/A;
+        f.b0 = 1 + alpha*A;
+        f.b1 = -2*cosw;
+        f.b2 = 1 - alpha*A;
+        f.a1 = -2*cosw;
+        f.a2 = 1 - alpha/A;
+    }
+
+    f.b0 /= a0;
+    f.b1 /= a0;
+    f.b2 /= a0;
+    f.a1 /= a0;
+    f.a2 /= a0;
+    designed[band] = decibels;
+}
@@ -0,0 +1,58 @@
+// Equalizer class: Three-band equalizer for live playback: a low shelf, a peak in the middle and a high
+//                  shelf, each a biquad filter (from Robert Bristow-Johnson's Audio EQ Cookbook) whose
+//                  gain can be turned up or down while audio is playing. Cheap enough to run on small
+//                  blocks in real time, with no latency.
+
+#pragma once
+#include <vector>
+#include <atomic>
+#include "Effect.h"
+using namespace std;
+
+const int EQ_BANDS = 3;                     //number of bands: bass, middle, treble
+const double EQ_FREQUENCIES[EQ_BANDS] = { 250.0, 1000.0, 4000.0 };     //center of each band, in Hz
+
+class Equalizer : public Effect
+{
+public:
+    Equalizer(int sampleRate = 44100);
+    // PRE:  sampleRate > 2*EQ_FREQUENCIES[EQ_BANDS-1]
+    // POST: A flat equalizer for audio sampled at sampleRate
+
+    void SetSampleRate(int sampleRate);
+    // PRE:  sampleRate > 2*EQ_FREQUENCIES[EQ_BANDS-1], Process is not running on another thread
+    // POST: The filters have been redesigned for audio sampled at sampleRate, and the equalizer is Reset().
+
+    void SetBand(int band, double decibels);
+    // PRE:  0 <= band < EQ_BANDS
+    // POST: From the next block passed to Process on, band band is boosted by decibels dB (cut if
+    //         negative). Safe to call from any thread while Process runs on another.
+
+    double GetBand(int band) const;
+    // PRE:  0 <= band < EQ_BANDS
+    // POST: FCTVAL == the gain of band band last set, in dB
+
+    void Process(double** block, int numChannels, int numFrames);
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every block[n] has been filtered by each band in turn.
+
+    void Reset();
+    // POST: The filters' history has been cleared.
+
+private:
+    class Biquad                            //coefficients of one filter, normalized so a0 == 1
+    {
+    public:
+        double b0, b1, b2, a1, a2;
+    };
+
+    void Design(int band, double decibels);
+    // PRE:  0 <= band < EQ_BANDS
+    // POST: filters[band] boosts its band by decibels dB at sampleRate, and designed[band] == decibels
+
+    int sampleRate;                         //samples per second of the audio processed
+    atomic<double> gains[EQ_BANDS];         //gain of each band asked for, in dB
+    double designed[EQ_BANDS];              //gain each filter was last designed for, in dB
+    Biquad filters[EQ_BANDS];               //one filter per band
+    vector<double> history;                 //two state variables per band per channel, channel after channel
+};
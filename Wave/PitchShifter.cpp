@@ -0,0 +1,102 @@
+// PitchShifter class: Shifts the pitch of live audio up or down without changing its speed, using a
+//                     delay line read by two taps that sweep through it faster or slower than it is
+//                     written. Each tap fades in and out as it wraps around, half a sweep apart from the
+//                     other, so the jumps are not heard as clicks. Far cheaper than a phase vocoder, at
+//                     the price of some roughness on large shifts.
+
+#include "PitchShifter.h"
+#include <math.h>
+using namespace std;
+
+PitchShifter::PitchShifter(int sampleRate)
+// PRE:  sampleRate > 0
+// POST: A pitch shifter for audio sampled at sampleRate, shifting by 0 semitones
+{
+    semitones = 0.0;
+    SetSampleRate(sampleRate);
+}
+
+void PitchShifter::SetSampleRate(int sampleRate)
+// PRE:  sampleRate > 0, Process is not running on another thread
+// POST: The delay line is sized for audio sampled at sampleRate, and the shifter is Reset().
+{
+    windowSize = int(PITCH_WINDOW_SECONDS*sampleRate);
+    for (unsigned int n=0; n < delay.size(); n++)
+        delay[n].resize(windowSize+2);                  //room to interpolate past the longest delay
+    Reset();
+}
+
+void PitchShifter::SetSemitones(double semitones)
+// POST: From the next block passed to Process on, the pitch is shifted by semitones semitones (down
+//         if negative). Safe to call from any thread while Process runs on another.
+{
+    this->semitones = semitones;
+}
+
+double PitchShifter::GetSemitones() const
+// POST: FCTVAL == the shift last set, in semitones
+{
+    return semitones;
+}
+
+void PitchShifter::Process(double** block, int numChannels, int numFrames)
+// PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+// POST: Every block[n] has been shifted in pitch. With a shift of 0 the samples pass straight through.
+{
+    double shift = semitones;
+    double ratio = pow(2.0, shift/12);                  //how much faster the taps read than the line is written
+    double sweep = (1-ratio)/windowSize;                //change in phase per frame
+    int size;                                           //frames in each ring
+    double taps[2];                                     //delay of each tap, in frames
+    double weights[2];                                  //how loud each tap is
+    double where;                                       //position of a tap in the ring
+    int before;                                         //frames of the ring either side of where
+    int after;
+    double output;
+
+    if (int(delay.size()) < numChannels)                //more channels than before
+        delay.resize(numChannels, vector<double>(windowSize+2, 0.0));
+    size = delay[0].size();
+
+    for (int i=0; i < numFrames; i++)
+    {
+        for (int t=0; t < 2; t++)                       //the second tap is half a sweep behind the first
+        {
+            double p = t == 0 ? phase : fmod(phase+0.5, 1.0);
+            taps[t] = p*windowSize;
+            weights[t] = 1-fabs(2*p-1);                 //triangle: silent at either end of the sweep, so
+        }                                               //  the two always add up to 1
+
+        for (int n=0; n < numChannels; n++)
+        {
+            delay[n][writeIndex] = block[n][i];
+            if (shift == 0.0)                           //nothing to shift: keep the line filled, so a shift
+                continue;                               //  can start without a gap
+
+            output = 0.0;
+            for (int t=0; t < 2; t++)
+            {
+                where = writeIndex - taps[t];
+                if (where < 0)
+                    where += size;
+                before = int(where);
+                after = (before+1)%size;
+                output += weights[t]*(delay[n][before] + (where-before)*(delay[n][after]-delay[n][before]));
+            }
+            block[n][i] = output;
+        }
+
+        writeIndex = (writeIndex+1)%size;
+        phase += sweep;                                 //reading faster than writing shortens the delay,
+        phase -= floor(phase);                          //  until the tap wraps around to the far end
+    }
+}
+
+void PitchShifter::Reset()
+// POST: The delay line has been cleared and the taps sent back to their starting places.
+{
+    for (unsigned int n=0; n < delay.size(); n++)
+        delay[n].assign(delay[n].size(), 0.0);
+    writeIndex = 0;
+    phase = 0.0;
+}
@@ -0,0 +1,47 @@
+// PitchShifter class: Shifts the pitch of live audio up or down without changing its speed, using a
+//                     delay line read by two taps that sweep through it faster or slower than it is
+//                     written. Each tap fades in and out as it wraps around, half a sweep apart from the
+//                     other, so the jumps are not heard as clicks. Far cheaper than a phase vocoder, at
+//                     the price of some roughness on large shifts.
+
+#pragma once
+#include <vector>
+#include <atomic>
+#include "Effect.h"
+using namespace std;
+
+const double PITCH_WINDOW_SECONDS = 0.04;   //length of the delay the taps sweep through
+
+class PitchShifter : public Effect
+{
+public:
+    PitchShifter(int sampleRate = 44100);
+    // PRE:  sampleRate > 0
+    // POST: A pitch shifter for audio sampled at sampleRate, shifting by 0 semitones
+
+    void SetSampleRate(int sampleRate);
+    // PRE:  sampleRate > 0, Process is not running on another thread
+    // POST: The delay line is sized for audio sampled at sampleRate, and the shifter is Reset().
+
+    void SetSemitones(double semitones);
+    // POST: From the next block passed to Process on, the pitch is shifted by semitones semitones (down
+    //         if negative). Safe to call from any thread while Process runs on another.
+
+    double GetSemitones() const;
+    // POST: FCTVAL == the shift last set, in semitones
+
+    void Process(double** block, int numChannels, int numFrames);
+    // PRE:  block[0..numChannels-1] each point to numFrames samples, numFrames >= 0
+    // POST: Every block[n] has been shifted in pitch. With a shift of 0 the samples pass straight through.
+
+    void Reset();
+    // POST: The delay line has been cleared and the taps sent back to their starting places.
+
+private:
+    atomic<double> semitones;               //shift asked for
+    int windowSize;                         //frames in the delay the taps sweep through
+    vector<vector<double> > delay;          //the last delay.size() frames written, per channel, as a ring
+    int writeIndex;                         //where the next frame is written in each ring
+    double phase;                           //how far through its sweep the first tap is (0...1); the
+                                            //  second is half a sweep further on
+};
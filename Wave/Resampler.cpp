@@ -0,0 +1,119 @@
+// Resampler class: Converts audio from one sample rate to another by windowed-sinc interpolation, for
+//                  playing songs of any rate on a device opened at a fixed one. It keeps no history, so
+//                  any stretch of the output can be worked out on its own: ask GetSpan which source
+//                  frames a block needs, hand them to Process, and carry on from any frame after a seek.
+//                  When both rates are the same, the source frames are copied as they are.
+
+#include "Resampler.h"
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+Resampler::Resampler() : kernel(RESAMPLER_ZEROS*RESAMPLER_PHASES + 2)
+// POST: A resampler from 44100 Hz to 44100 Hz, with its kernel tabulated
+{
+    double x;                                           //zero crossings from the center
+
+    for (unsigned int i=0; i < kernel.size(); i++)      //sinc, tapered to 0 by a Blackman window
+    {
+        x = double(i)/RESAMPLER_PHASES;
+        if (x >= RESAMPLER_ZEROS)
+            kernel[i] = 0.0;
+        else if (i == 0)
+            kernel[i] = 1.0;
+        else
+            kernel[i] = sin(M_PI*x)/(M_PI*x) * (0.42 + 0.5*cos(M_PI*x/RESAMPLER_ZEROS)
+                                                     + 0.08*cos(2*M_PI*x/RESAMPLER_ZEROS));
+    }
+
+    SetRates(44100, 44100);
+}
+
+void Resampler::SetRates(int inRate, int outRate)
+// PRE:  inRate > 0, outRate > 0
+// POST: The resampler converts audio sampled at inRate to audio sampled at outRate.
+{
+    this->inRate = inRate;
+    this->outRate = outRate;
+    step = double(inRate)/outRate;
+    cutoff = RESAMPLER_BANDWIDTH*min(1.0, double(outRate)/inRate);     //below both Nyquist frequencies
+    halfWidth = RESAMPLER_ZEROS/cutoff;                                 //the kernel widens as it narrows
+    weights.resize(long(2*halfWidth) + 2);
+}
+
+long Resampler::GetOutputLength(long inFrames) const
+// PRE:  inFrames >= 0
+// POST: FCTVAL == the number of frames inFrames frames of source become at the output rate
+{
+    return ((long long)(inFrames)*outRate + inRate - 1)/inRate;        //output frames that fall before the end
+}
+
+void Resampler::GetSpan(long outStart, int frames, long inFrames, long& first, long& last) const
+// PRE:  outStart >= 0, frames > 0, inFrames >= 0
+// POST: Frames first...last-1 of a source inFrames frames long are all Process needs to work out
+//       output frames outStart...outStart+frames-1; 0 <= first <= last <= inFrames.
+{
+    if (inRate == outRate)                              //copied straight across
+    {
+        first = outStart;
+        last = outStart+frames;
+    }
+    else
+    {
+        first = long(ceil(outStart*step - halfWidth));
+        last = long(floor((outStart+frames-1)*step + halfWidth)) + 1;
+    }
+
+    first = max(0L, min(first, inFrames));
+    last = max(first, min(last, inFrames));
+}
+
+void Resampler::Process(const double* const* input, int numChannels, long first, long last, long outStart,
+                        double** output, int frames)
+// PRE:  first and last are as GetSpan gave for outStart and frames, input[n][i] is frame first+i of
+//       channel n of the source, output[0..numChannels-1] each have room for frames samples
+// POST: output[n][k] == frame outStart+k of channel n at the output rate, for 0 <= k < frames,
+//       the source being silent outside first...last-1
+{
+    double at;                                          //source position of the output frame, in frames
+    long from;                                          //source frames reaching it
+    long to;
+    double sum;
+
+    if (inRate == outRate)
+    {
+        for (int n=0; n < numChannels; n++)
+            for (int k=0; k < frames; k++)
+                output[n][k] = outStart+k < last ? input[n][outStart+k-first] : 0.0;
+        return;
+    }
+
+    for (int k=0; k < frames; k++)
+    {
+        at = (outStart+k)*step;                         //worked out afresh, so no error builds up
+        from = max(first, long(ceil(at - halfWidth)));
+        to = min(last-1, long(floor(at + halfWidth)));
+        for (long j=from; j <= to; j++)                 //the same for every channel
+            weights[j-from] = cutoff*Kernel(fabs(at-j)*cutoff);     //cutoff keeps the gain at 1 in the passband
+        for (int n=0; n < numChannels; n++)
+        {
+            sum = 0.0;
+            for (long j=from; j <= to; j++)
+                sum += input[n][j-first] * weights[j-from];
+            output[n][k] = sum;
+        }
+    }
+}
+
+double Resampler::Kernel(double x) const
+// PRE:  x >= 0
+// POST: FCTVAL == the windowed sinc at x zero crossings from its center, 0 from RESAMPLER_ZEROS on
+{
+    double place = x*RESAMPLER_PHASES;                  //position in the table
+    int i = int(place);
+
+    if (i >= RESAMPLER_ZEROS*RESAMPLER_PHASES)
+        return 0.0;
+
+    return kernel[i] + (place-i)*(kernel[i+1]-kernel[i]);     //between the two nearest values
+}
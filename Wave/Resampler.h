@@ -0,0 +1,55 @@
+// Resampler class: Converts audio from one sample rate to another by windowed-sinc interpolation, for
+//                  playing songs of any rate on a device opened at a fixed one. It keeps no history, so
+//                  any stretch of the output can be worked out on its own: ask GetSpan which source
+//                  frames a block needs, hand them to Process, and carry on from any frame after a seek.
+//                  When both rates are the same, the source frames are copied as they are.
+
+#pragma once
+#include <vector>
+using namespace std;
+
+const int RESAMPLER_ZEROS = 16;             //zero crossings of the sinc kernel on each side of its center
+const int RESAMPLER_PHASES = 512;           //kernel values tabulated between one zero crossing and the next
+const double RESAMPLER_BANDWIDTH = 0.95;    //share of the lower Nyquist frequency passed; the filter rolls
+                                            //  off above it, so nothing folds back from beyond it
+
+class Resampler
+{
+public:
+    Resampler();
+    // POST: A resampler from 44100 Hz to 44100 Hz, with its kernel tabulated
+
+    void SetRates(int inRate, int outRate);
+    // PRE:  inRate > 0, outRate > 0
+    // POST: The resampler converts audio sampled at inRate to audio sampled at outRate.
+
+    long GetOutputLength(long inFrames) const;
+    // PRE:  inFrames >= 0
+    // POST: FCTVAL == the number of frames inFrames frames of source become at the output rate
+
+    void GetSpan(long outStart, int frames, long inFrames, long& first, long& last) const;
+    // PRE:  outStart >= 0, frames > 0, inFrames >= 0
+    // POST: Frames first...last-1 of a source inFrames frames long are all Process needs to work out
+    //       output frames outStart...outStart+frames-1; 0 <= first <= last <= inFrames.
+
+    void Process(const double* const* input, int numChannels, long first, long last, long outStart,
+                 double** output, int frames);
+    // PRE:  first and last are as GetSpan gave for outStart and frames, input[n][i] is frame first+i of
+    //       channel n of the source, output[0..numChannels-1] each have room for frames samples
+    // POST: output[n][k] == frame outStart+k of channel n at the output rate, for 0 <= k < frames,
+    //       the source being silent outside first...last-1
+
+private:
+    double Kernel(double x) const;
+    // PRE:  x >= 0
+    // POST: FCTVAL == the windowed sinc at x zero crossings from its center, 0 from RESAMPLER_ZEROS on
+
+    vector<double> kernel;                  //Kernel at every 1/RESAMPLER_PHASES of a zero crossing
+    int inRate;                             //sample rates converted from and to
+    int outRate;
+    double step;                            //source frames per output frame
+    double cutoff;                          //cutoff of the low-pass filter, as a fraction of the source's
+                                            //  Nyquist frequency
+    double halfWidth;                       //source frames either side of an output frame that reach it
+    vector<double> weights;                 //what each of those frames is multiplied by, for one output frame
+};
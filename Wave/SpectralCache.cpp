@@ -0,0 +1,78 @@
+// SpectralCache class: Constant-Q spectra of every frame of a Wave, computed ahead of time on a
+//                      background thread and stored as 8-bit log magnitudes, so a visualization only
+//                      has to look a frame up instead of taking a transform while it draws.
+
+#include "SpectralCache.h"
+#include "Wave.h"
+using namespace std;
+
+SpectralCache::SpectralCache(Wave& wave, int hopSize, const ConstantQ& analyzer)
+    : analyzer(analyzer)
+// PRE:  wave is initialized, hopSize > 0, analyzer was built for the sample rate of wave
+// POST: A copy of the first channel of wave and of analyzer has been taken and a background thread
+//         has started computing the note levels (see ConstantQ::Levels) of frames centered hopSize
+//         samples apart. wave and analyzer may be deleted as soon as this returns.
+{
+    signal = wave[0];
+
+    this->hopSize = hopSize;
+    numBins = analyzer.GetNumBins();
+    numFrames = (signal.size()+hopSize-1)/hopSize;
+    levels.resize(long(numFrames)*numBins);
+
+    framesDone = 0;
+    cancelled = false;
+    worker = thread(&SpectralCache::Run, this);     //start last, once every member is ready
+}
+
+SpectralCache::~SpectralCache()
+// POST: The background thread has been stopped and all memory is freed.
+{
+    cancelled = true;
+    worker.join();
+}
+
+bool SpectralCache::Ready(int frame) const
+// POST: FCTVAL == true iff frame frame exists and has been computed
+{
+    return frame >= 0 && frame < framesDone;
+}
+
+const unsigned char* SpectralCache::operator [](int frame) const
+// PRE:  Ready(frame)
+// POST: FCTVAL == the GetNumBins() levels of frame frame (centered on sample frame*GetHopSize()),
+//                 lowest note first
+{
+    return &levels[long(frame)*numBins];
+}
+
+int SpectralCache::GetNumFrames() const
+// POST: FCTVAL == the total number of frames the cache will hold once complete
+{
+    return numFrames;
+}
+
+int SpectralCache::GetNumBins() const
+// POST: FCTVAL == the number of note bins per frame
+{
+    return numBins;
+}
+
+int SpectralCache::GetHopSize() const
+// POST: FCTVAL == the number of samples between the starts of consecutive frames
+{
+    return hopSize;
+}
+
+void SpectralCache::Run()
+// POST: Every frame has been computed in order, framesDone advancing after each, unless cancelled
+//         was set first.
+{
+    vector<complex<double> > scratch(analyzer.GetFFTSize());   //FFT buffer reused for every frame
+
+    for (int frame=0; frame < numFrames && !cancelled; frame++)
+    {
+        analyzer.Levels(signal, long(frame)*hopSize, scratch, &levels[long(frame)*numBins]);
+        framesDone = frame+1;                                   //publish the frame only once it is written
+    }
+}
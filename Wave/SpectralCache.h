@@ -0,0 +1,59 @@
+// SpectralCache class: Constant-Q spectra of every frame of a Wave, computed ahead of time on a
+//                      background thread and stored as 8-bit log magnitudes, so a visualization only
+//                      has to look a frame up instead of taking a transform while it draws.
+
+#pragma once
+#include <vector>
+#include <complex>
+#include <thread>
+#include <atomic>
+#include "ConstantQ.h"
+using namespace std;
+
+class Wave;
+
+class SpectralCache
+{
+public:
+    SpectralCache(Wave& wave, int hopSize, const ConstantQ& analyzer);
+    // PRE:  wave is initialized, hopSize > 0, analyzer was built for the sample rate of wave
+    // POST: A copy of the first channel of wave and of analyzer has been taken and a background thread
+    //         has started computing the note levels (see ConstantQ::Levels) of frames centered hopSize
+    //         samples apart. wave and analyzer may be deleted as soon as this returns.
+
+    ~SpectralCache();
+    // POST: The background thread has been stopped and all memory is freed.
+
+    bool Ready(int frame) const;
+    // POST: FCTVAL == true iff frame frame exists and has been computed
+
+    const unsigned char* operator [](int frame) const;
+    // PRE:  Ready(frame)
+    // POST: FCTVAL == the GetNumBins() levels of frame frame (centered on sample frame*GetHopSize()),
+    //                 lowest note first
+
+    int GetNumFrames() const;
+    // POST: FCTVAL == the total number of frames the cache will hold once complete
+
+    int GetNumBins() const;
+    // POST: FCTVAL == the number of note bins per frame
+
+    int GetHopSize() const;
+    // POST: FCTVAL == the number of samples between the starts of consecutive frames
+
+private:
+    vector<double> signal;                  //copy of the audio being analyzed
+    ConstantQ analyzer;                     //turns each frame into note levels
+    vector<unsigned char> levels;           //numFrames rows of numBins levels each, stored row after row
+    int numFrames;                          //number of frames in the whole signal
+    int numBins;                            //number of frequency bins per frame
+    int hopSize;                            //number of samples between the starts of consecutive frames
+
+    atomic<int> framesDone;                 //frames 0..framesDone-1 are ready to be read
+    atomic<bool> cancelled;                 //set to ask the background thread to stop early
+    thread worker;                          //background thread filling in levels
+
+    void Run();
+    // POST: Every frame has been computed in order, framesDone advancing after each, unless cancelled
+    //         was set first.
+};
@@ -0,0 +1,112 @@
+// SpectralProcessor class: Block-wise processing of a Wave in the frequency domain. Each channel is
+//                          cut into overlapping windowed blocks, each block is transformed, handed to
+//                          ProcessSpectrum to be altered, transformed back, and the blocks are
+//                          overlap-added into the result. Derive from it and override ProcessSpectrum
+//                          to build an effect (EQ, filter, denoiser...).
+
+#include "SpectralProcessor.h"
+#include "Wave.h"
+#include "Utility.h"
+#include <iostream>
+using namespace std;
+
+SpectralProcessor::SpectralProcessor(int fftSize, int hopSize, WindowType window)
+// PRE:  fftSize is a power of 2, 0 < hopSize <= fftSize/2, Assigned(window)
+// POST: The processor will work on blocks of fftSize samples, hopSize samples apart, tapered by window
+//         both before the forward transform and after the inverse transform.
+{
+    this->fftSize = fftSize;
+    this->hopSize = hopSize;
+    this->window = window;
+}
+
+SpectralProcessor::~SpectralProcessor()
+// POST: Object is completely removed from virtual memory
+{
+}
+
+void SpectralProcessor::Apply(Wave& wave)
+// PRE:  wave is initialized
+// POST: Every channel of wave has been replaced by its processed version. The length of wave is unchanged.
+{
+    cout << "Processing Spectrum...\n";                     //Display friendly progress message
+
+    for (int n=0; n < wave.GetNumChannels(); n++)
+    {
+        Utility::Bar(cout, n, wave.GetNumChannels());       //Display friendly progress bar
+        wave[n] = Apply(wave[n], wave.GetSampleRate(), n);
+    }
+
+    Utility::Bar(cout, wave.GetNumChannels(), wave.GetNumChannels());
+    cout << endl;
+}
+
+vector<double> SpectralProcessor::Apply(const vector<double>& signal, int sampleRate, int channel)
+// PRE:  sampleRate > 0
+// POST: FCTVAL == signal processed block by block; same length as signal. If ProcessSpectrum leaves
+//         every spectrum unchanged, FCTVAL == signal (up to rounding).
+{
+    const vector<double>& table = Window::Table(window, fftSize);  //window coefficients, used twice per block
+    long length = signal.size();
+    long offset = fftSize-hopSize;                      //the first block starts this many samples before the signal
+    vector<double> output(offset+length+fftSize, 0.0); //overlap-added blocks, shifted by offset so that blocks
+                                                        //  hanging off either end of the signal have somewhere to go
+    vector<double> weight(output.size(), 0.0);         //sum of squared window coefficients landing on each sample
+    vector<complex<double> > block(fftSize);           //the block being processed
+
+    // Blocks start early enough that the first sample is covered by as many blocks as any other; dividing by
+    // the summed squared window afterwards undoes the two tapers exactly, whatever the window and overlap.
+    for (long start=-offset; start < length; start += hopSize)
+    {
+        for (int i=0; i < fftSize; i++)                 //cut out and taper the block (silence outside the signal)
+            block[i] = complex<double>(start+i >= 0 && start+i < length ? signal[start+i]*table[i] : 0.0, 0.0);
+
+        Utility::FFTInPlace(block);
+        ProcessSpectrum(block, sampleRate, channel);
+        Utility::IFFTInPlace(block);
+
+        for (int i=0; i < fftSize; i++)                 //taper again so block edges fade out, then add
+        {
+            output[offset+start+i] += block[i].real()*table[i];
+            weight[offset+start+i] += table[i]*table[i];
+        }
+    }
+
+    vector<double> result(length);                      //output, with the shift removed and the window undone
+    for (long i=0; i < length; i++)
+        result[i] = weight[offset+i] > 1e-9 ? output[offset+i]/weight[offset+i] : 0.0;
+
+    return result;
+}
+
+double SpectralProcessor::BinFrequency(int bin, int sampleRate) const
+// PRE:  0 <= bin <= fftSize/2
+// POST: FCTVAL == the frequency in Hz at the center of bin bin
+{
+    return double(bin)*sampleRate/fftSize;
+}
+
+BandPassFilter::BandPassFilter(double lowHz, double highHz, int fftSize)
+    : SpectralProcessor(fftSize, fftSize/4, HANN)
+// PRE:  0 <= lowHz < highHz, fftSize is a power of 2
+// POST: The filter will keep frequencies between lowHz and highHz and silence all others.
+{
+    this->lowHz = lowHz;
+    this->highHz = highHz;
+}
+
+void BandPassFilter::ProcessSpectrum(vector<complex<double> >& spectrum, int sampleRate, int)
+// POST: Every bin whose frequency lies outside [lowHz, highHz] (and its mirror image above Nyquist)
+//         has been set to zero.
+{
+    for (int bin=0; bin <= fftSize/2; bin++)
+    {
+        double frequency = BinFrequency(bin, sampleRate);
+
+        if (frequency < lowHz || frequency > highHz)
+        {
+            spectrum[bin] = 0;
+            spectrum[(fftSize-bin) % fftSize] = 0;      //mirror bin, so the block stays real
+        }
+    }
+}
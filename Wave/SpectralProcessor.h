@@ -0,0 +1,65 @@
+// SpectralProcessor class: Block-wise processing of a Wave in the frequency domain. Each channel is
+//                          cut into overlapping windowed blocks, each block is transformed, handed to
+//                          ProcessSpectrum to be altered, transformed back, and the blocks are
+//                          overlap-added into the result. Derive from it and override ProcessSpectrum
+//                          to build an effect (EQ, filter, denoiser...).
+
+#pragma once
+#include <vector>
+#include <complex>
+#include "Window.h"
+using namespace std;
+
+class Wave;
+
+class SpectralProcessor
+{
+public:
+    SpectralProcessor(int fftSize = 2048, int hopSize = 512, WindowType window = HANN);
+    // PRE:  fftSize is a power of 2, 0 < hopSize <= fftSize/2, Assigned(window)
+    // POST: The processor will work on blocks of fftSize samples, hopSize samples apart, tapered by window
+    //         both before the forward transform and after the inverse transform.
+
+    virtual ~SpectralProcessor();
+    // POST: Object is completely removed from virtual memory
+
+    void Apply(Wave& wave);
+    // PRE:  wave is initialized
+    // POST: Every channel of wave has been replaced by its processed version. The length of wave is unchanged.
+
+    vector<double> Apply(const vector<double>& signal, int sampleRate, int channel = 0);
+    // PRE:  sampleRate > 0
+    // POST: FCTVAL == signal processed block by block; same length as signal. If ProcessSpectrum leaves
+    //         every spectrum unchanged, FCTVAL == signal (up to rounding).
+
+protected:
+    virtual void ProcessSpectrum(vector<complex<double> >& spectrum, int sampleRate, int channel) = 0;
+    // PRE:  spectrum holds the fftSize-point FFT of one windowed block of channel channel, sampled at sampleRate
+    // POST: spectrum has been altered as the effect requires. Bins k and fftSize-k should stay complex
+    //         conjugates of each other so that the block transforms back to real samples.
+
+    double BinFrequency(int bin, int sampleRate) const;
+    // PRE:  0 <= bin <= fftSize/2
+    // POST: FCTVAL == the frequency in Hz at the center of bin bin
+
+    int fftSize;                            //number of samples in each block
+    int hopSize;                            //number of samples between the starts of consecutive blocks
+    WindowType window;                      //taper applied to each block on the way in and on the way out
+};
+
+class BandPassFilter : public SpectralProcessor
+{
+public:
+    BandPassFilter(double lowHz, double highHz, int fftSize = 4096);
+    // PRE:  0 <= lowHz < highHz, fftSize is a power of 2
+    // POST: The filter will keep frequencies between lowHz and highHz and silence all others.
+
+protected:
+    void ProcessSpectrum(vector<complex<double> >& spectrum, int sampleRate, int channel);
+    // POST: Every bin whose frequency lies outside [lowHz, highHz] (and its mirror image above Nyquist)
+    //         has been set to zero.
+
+private:
+    double lowHz;                           //lowest frequency passed, in Hz
+    double highHz;                          //highest frequency passed, in Hz
+};
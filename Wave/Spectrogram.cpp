@@ -0,0 +1,160 @@
+// Spectrogram class: Short-time Fourier transform of a whole Wave. The signal is cut into
+//                    overlapping frames of fftSize samples, hopSize samples apart, each frame is
+//                    windowed and transformed, and the magnitude of every frequency bin is kept.
+
+#include "Spectrogram.h"
+#include "Wave.h"
+#include "Utility.h"
+#include <thread>
+#include <math.h>
+using namespace std;
+
+Spectrogram::Spectrogram(Wave& wave, int fftSize, int hopSize, WindowType window, int channel)
+// PRE:  wave is initialized, fftSize is a power of 2, hopSize > 0, -1 <= channel < number of
+//         channels in wave
+// POST: The magnitude spectrum of every frame of channel channel of wave has been computed. When
+//         channel is -1, all channels are mixed down to one before transforming.
+{
+    this->fftSize = fftSize;
+    this->hopSize = hopSize;
+    sampleRate = wave.GetSampleRate();
+
+    if (channel >= 0)                                           //a single channel can be transformed
+        Compute(wave[channel], window);                         //  straight from the wave's data
+    else
+    {
+        vector<double> mix(wave.GetSamplesPerChannel(), 0.0);   //average of all channels
+
+        for (int n=0; n < wave.GetNumChannels(); n++)
+            for (long i=0; i < wave.GetSamplesPerChannel(); i++)
+                mix[i] += wave[n][i]/wave.GetNumChannels();
+
+        Compute(mix, window);
+    }
+}
+
+Spectrogram::Spectrogram(const vector<double>& signal, int sampleRate, int fftSize, int hopSize,
+                         WindowType window)
+// PRE:  sampleRate > 0, fftSize is a power of 2, hopSize > 0
+// POST: The magnitude spectrum of every frame of signal has been computed.
+{
+    this->fftSize = fftSize;
+    this->hopSize = hopSize;
+    this->sampleRate = sampleRate;
+
+    Compute(signal, window);
+}
+
+const float* Spectrogram::operator [](int frame) const
+// PRE:  0 <= frame < GetNumFrames()
+// POST: FCTVAL == the GetNumBins() magnitudes of frame frame, lowest frequency first
+{
+    return &magnitudes[long(frame)*numBins];
+}
+
+float Spectrogram::Magnitude(int frame, int bin) const
+// PRE:  0 <= frame < GetNumFrames(), 0 <= bin < GetNumBins()
+// POST: FCTVAL == magnitude of frequency bin bin in frame frame
+{
+    return magnitudes[long(frame)*numBins+bin];
+}
+
+double Spectrogram::BinFrequency(int bin) const
+// PRE:  0 <= bin < GetNumBins()
+// POST: FCTVAL == the center frequency of bin bin, in Hz
+{
+    return double(bin)*sampleRate/fftSize;
+}
+
+int Spectrogram::GetNumFrames() const
+// POST: FCTVAL == the number of frames (time slices) in the spectrogram
+{
+    return numFrames;
+}
+
+int Spectrogram::GetNumBins() const
+// POST: FCTVAL == the number of frequency bins per frame, fftSize/2+1
+{
+    return numBins;
+}
+
+int Spectrogram::GetHopSize() const
+// POST: FCTVAL == the number of samples between the starts of consecutive frames
+{
+    return hopSize;
+}
+
+float Spectrogram::GetMaxMagnitude() const
+// POST: FCTVAL == the largest magnitude in any bin of any frame
+{
+    return maxMagnitude;
+}
+
+void Spectrogram::TransformFrame(const vector<double>& signal, long start, const vector<double>& window,
+                                 vector<complex<double> >& scratch)
+// PRE:  window.size() == scratch.size() is a power of 2, start >= 0
+// POST: scratch holds the FFT of the window.size() samples of signal beginning at start,
+//         multiplied by window. Samples past the end of signal are taken as silence.
+{
+    long available = long(signal.size())-start;                 //samples left in signal from start on
+    int size = window.size();
+
+    for (int i=0; i < size; i++)
+        scratch[i] = complex<double>(i < available ? signal[start+i]*window[i] : 0.0, 0.0);
+
+    Utility::FFTInPlace(scratch);
+}
+
+void Spectrogram::Compute(const vector<double>& signal, WindowType window)
+// PRE:  fftSize, hopSize, and sampleRate are initialized
+// POST: magnitudes holds the spectrogram of signal. Frames are split evenly between as many
+//         threads as the machine has cores.
+{
+    const vector<double>& table = Window::Table(window, fftSize);  //window coefficients, shared by all frames
+    vector<thread> workers;                                     //one thread per slice of frames
+    int numThreads = thread::hardware_concurrency();            //how many slices to cut the frames into
+
+    numFrames = (signal.size()+hopSize-1)/hopSize;              //enough frames to cover every sample
+    if (numFrames < 1)
+        numFrames = 1;
+    numBins = fftSize/2+1;                                      //bins above Nyquist mirror those below
+
+    magnitudes.assign(long(numFrames)*numBins, 0.0f);
+
+    if (numThreads < 1)                                         //hardware_concurrency may not know
+        numThreads = 1;
+    if (numThreads > numFrames)
+        numThreads = numFrames;
+
+    for (int t=1; t < numThreads; t++)                          //hand every slice but the first to a
+        workers.push_back(thread(&Spectrogram::ComputeFrames,   //  worker thread...
+                                 this, cref(signal), cref(table),
+                                 long(numFrames)*t/numThreads,
+                                 long(numFrames)*(t+1)/numThreads));
+
+    ComputeFrames(signal, table, 0, numFrames/numThreads);      //...and do the first slice ourselves
+
+    for (unsigned int t=0; t < workers.size(); t++)
+        workers[t].join();
+
+    maxMagnitude = 0;
+    for (unsigned long i=0; i < magnitudes.size(); i++)
+        if (magnitudes[i] > maxMagnitude)
+            maxMagnitude = magnitudes[i];
+}
+
+void Spectrogram::ComputeFrames(const vector<double>& signal, const vector<double>& window, int firstFrame,
+                                int lastFrame)
+// PRE:  0 <= firstFrame <= lastFrame <= numFrames, magnitudes is sized
+// POST: rows firstFrame..lastFrame-1 of magnitudes hold the spectra of those frames of signal
+{
+    vector<complex<double> > scratch(fftSize);                  //this thread's FFT buffer
+
+    for (int frame=firstFrame; frame < lastFrame; frame++)
+    {
+        TransformFrame(signal, long(frame)*hopSize, window, scratch);
+
+        for (int bin=0; bin < numBins; bin++)
+            magnitudes[long(frame)*numBins+bin] = abs(scratch[bin]);
+    }
+}
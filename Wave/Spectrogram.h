@@ -0,0 +1,76 @@
+// Spectrogram class: Short-time Fourier transform of a whole Wave. The signal is cut into
+//                    overlapping frames of fftSize samples, hopSize samples apart, each frame is
+//                    windowed and transformed, and the magnitude of every frequency bin is kept.
+
+#pragma once
+#include <vector>
+#include <complex>
+#include "Window.h"
+using namespace std;
+
+class Wave;
+
+class Spectrogram
+{
+public:
+    Spectrogram(Wave& wave, int fftSize = 1024, int hopSize = 512, WindowType window = HANN,
+                int channel = -1);
+    // PRE:  wave is initialized, fftSize is a power of 2, hopSize > 0, -1 <= channel < number of
+    //         channels in wave
+    // POST: The magnitude spectrum of every frame of channel channel of wave has been computed. When
+    //         channel is -1, all channels are mixed down to one before transforming.
+
+    Spectrogram(const vector<double>& signal, int sampleRate, int fftSize = 1024, int hopSize = 512,
+                WindowType window = HANN);
+    // PRE:  sampleRate > 0, fftSize is a power of 2, hopSize > 0
+    // POST: The magnitude spectrum of every frame of signal has been computed.
+
+    const float* operator [](int frame) const;
+    // PRE:  0 <= frame < GetNumFrames()
+    // POST: FCTVAL == the GetNumBins() magnitudes of frame frame, lowest frequency first
+
+    float Magnitude(int frame, int bin) const;
+    // PRE:  0 <= frame < GetNumFrames(), 0 <= bin < GetNumBins()
+    // POST: FCTVAL == magnitude of frequency bin bin in frame frame
+
+    double BinFrequency(int bin) const;
+    // PRE:  0 <= bin < GetNumBins()
+    // POST: FCTVAL == the center frequency of bin bin, in Hz
+
+    int GetNumFrames() const;
+    // POST: FCTVAL == the number of frames (time slices) in the spectrogram
+
+    int GetNumBins() const;
+    // POST: FCTVAL == the number of frequency bins per frame, fftSize/2+1
+
+    int GetHopSize() const;
+    // POST: FCTVAL == the number of samples between the starts of consecutive frames
+
+    float GetMaxMagnitude() const;
+    // POST: FCTVAL == the largest magnitude in any bin of any frame
+
+    static void TransformFrame(const vector<double>& signal, long start, const vector<double>& window,
+                               vector<complex<double> >& scratch);
+    // PRE:  window.size() == scratch.size() is a power of 2, start >= 0
+    // POST: scratch holds the FFT of the window.size() samples of signal beginning at start,
+    //         multiplied by window. Samples past the end of signal are taken as silence.
+
+private:
+    vector<float> magnitudes;       //numFrames rows of numBins magnitudes each, stored row after row
+    int numFrames;                  //number of time slices
+    int numBins;                    //number of frequency bins per time slice
+    int fftSize;                    //number of samples transformed per frame
+    int hopSize;                    //number of samples between the starts of consecutive frames
+    int sampleRate;                 //sample rate of the transformed signal, in Hz
+    float maxMagnitude;             //largest magnitude in the spectrogram
+
+    void Compute(const vector<double>& signal, WindowType window);
+    // PRE:  fftSize, hopSize, and sampleRate are initialized
+    // POST: magnitudes holds the spectrogram of signal. Frames are split evenly between as many
+    //         threads as the machine has cores.
+
+    void ComputeFrames(const vector<double>& signal, const vector<double>& window, int firstFrame,
+                       int lastFrame);
+    // PRE:  0 <= firstFrame <= lastFrame <= numFrames, magnitudes is sized
+    // POST: rows firstFrame..lastFrame-1 of magnitudes hold the spectra of those frames of signal
+};
@@ -278,37 +278,80 @@ string Utility::StringFromDouble(double x)
 }
 
 vector<complex<double> > Utility::FFT(const vector<complex<double> >& input)
+//PRE:  input.size() is a power of 2
+//POST: FCTVAL == the discrete Fourier transform of input
 {
-	int n = input.size();		   			//number of elements in our data vector
-	vector<complex<double> > even;			//stores the even-index elements of input
-	vector<complex<double> > odd;			//stores the odd-index elements of input
-	complex<double> Wn(cos(2.0*M_PI/n),	    //each element of our basis is (e^(-2*Pi*i))^k(n)
-					   sin(2.0*M_PI/n));	//this is a convenient representation of the above exponent's base
-	complex<double> basis_k(1.0, 0.0);		//holds each of the k basis vectors
-	vector<complex<double> > output;			//the DFT of our data
-	vector<complex<double> > output_1stHalf;	//first half of output (needed for divide and conquer strategy)
-	vector<complex<double> > output_2ndHalf; //second half of output (needed for divide and conquer strategy)
-	
-	if (n == 1)								//base case
-		return input;
-		
-	for (int i=0; i < n/2; i++)				//separate input into odds and evens (divide and conquer)
-	{
-		even.push_back(input[2*i]);
-		odd.push_back(input[2*i+1]);
+	vector<complex<double> > output(input);	//the DFT of our data, transformed in place
+
+	FFTInPlace(output);
+
+	return output;
+}
+
+void Utility::FFTInPlace(vector<complex<double> >& data)
+//PRE:  data.size() is a power of 2
+//POST: data has been replaced by its discrete Fourier transform. No memory is allocated, so this
+//      is the version to call once per block when transforming many blocks of the same size.
+{
+	int n = data.size();					//number of elements in our data vector
+	int j = 0;								//bit-reversed counterpart of i
+
+	for (int i=1; i < n; i++)				//reorder the input so each butterfly pass below can work on
+	{										//  neighbouring elements (the order the recursive
+		int bit = n >> 1;					//  divide and conquer would have visited them in)
+
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+
+		if (i < j)
+			swap(data[i], data[j]);
 	}
-	
-	output_1stHalf = FFT(even);				//Transform the even half (recursively)
-	output_2ndHalf = FFT(odd);				//Transform the odd half (recursively)
-	
-	output.resize(n);
-		
-	for (int k=0; k < n/2; k++)				//"Butterfly" each pair of k and k+N/2 elements...
+
+	for (int len=2; len <= n; len <<= 1)	//combine transforms of size len/2 into transforms of size len
 	{
-		output[k] = output_1stHalf[k] + basis_k*output_2ndHalf[k];
-		output[k+n/2] = output_1stHalf[k] - basis_k*output_2ndHalf[k];
-		basis_k *= Wn;
+		complex<double> Wn(cos(2.0*M_PI/len),	//each element of our basis is (e^(-2*Pi*i/len))^k
+						   -sin(2.0*M_PI/len));
+
+		for (int start=0; start < n; start += len)
+		{
+			complex<double> basis_k(1.0, 0.0);	//holds each of the k basis vectors
+
+			for (int k=0; k < len/2; k++)		//"Butterfly" each pair of k and k+len/2 elements...
+			{
+				complex<double> even = data[start+k];
+				complex<double> odd = basis_k*data[start+k+len/2];
+
+				data[start+k] = even + odd;
+				data[start+k+len/2] = even - odd;
+				basis_k *= Wn;
+			}
+		}
 	}
-	
+}
+
+vector<complex<double> > Utility::IFFT(const vector<complex<double> >& input)
+//PRE:  input.size() is a power of 2
+//POST: FCTVAL == the inverse discrete Fourier transform of input, i.e. IFFT(FFT(x)) == x
+{
+	vector<complex<double> > output(input);	//the inverse DFT of our data, transformed in place
+
+	IFFTInPlace(output);
+
 	return output;
 }
+
+void Utility::IFFTInPlace(vector<complex<double> >& data)
+//PRE:  data.size() is a power of 2
+//POST: data has been replaced by its inverse discrete Fourier transform
+{
+	int n = data.size();					//number of elements in our data vector
+
+	for (int i=0; i < n; i++)				//the inverse transform is the forward transform run on the
+		data[i] = conj(data[i]);			//  complex conjugate, conjugated back and scaled by 1/n
+
+	FFTInPlace(data);
+
+	for (int i=0; i < n; i++)
+		data[i] = conj(data[i])/double(n);
+}
@@ -23,4 +23,7 @@ public:
     static int NumDecimals(double x);
     static string StringFromDouble(double x);
     static vector<complex<double> > FFT(const vector<complex<double> >& input);
+    static void FFTInPlace(vector<complex<double> >& data);
+    static vector<complex<double> > IFFT(const vector<complex<double> >& input);
+    static void IFFTInPlace(vector<complex<double> >& data);
 };
@@ -2,6 +2,9 @@
 #include <stdlib.h>
 #include "Utility.h"
 #include "Turtle.h"
+#include "Spectrogram.h"
+#include "SpectralProcessor.h"
+#include "Convolver.h"
 #include <string>
 #include <iostream>
 using namespace std;
@@ -13,6 +16,7 @@ const int MSFOOTERSIZE = 48;           //size in bytes of Microsoft wav footer
 const double WHOLENOTETIME = 2;        //how long to play a whole note, in seconds
 const int DEFSAMPLERATE = 22050;       //how many samples of sound are made per second, default
 const double DEFAMPLITUDE = 0.7;       //maximum amplitude of sound waves
+const double SPECTRUMFLOOR = -80;      //quietest level in decibels (relative to the loudest bin) shown by WriteSpectrogram
 
 Wave::Wave()
 // POST: default Wave object is constructed.
@@ -43,6 +47,21 @@ Wave::Wave(const char* theFile)
         WavInit();
 }
 
+Wave::Wave(const char* theFile, int sampleRate, int numChannels)
+//PRE:  sampleRate > 0, numChannels > 0
+//POST: An empty 16-bit wave of numChannels channels at sampleRate Hz, its file name theFile, for
+//        audio decoded elsewhere to be added to with AppendPCM.
+{
+    fileName = theFile;
+    this->sampleRate = sampleRate;
+    this->numChannels = numChannels;
+    qLevel = 16;
+    fileSize = HEADERSIZE;                                          //a .wav of no samples is all header
+    samplesPerChannel = 0;
+    songLength = 0.0;
+    wavData = new vector<double>[numChannels];
+}
+
 Wave::Wave(Wave& toCopy)
 //PRE: toCopy is initialized
 //POST: FCTVAL == A new wave object is constructed with the same contents as toCopy
@@ -200,6 +219,39 @@ void Wave::BackChannel(string start, string end)
     BackChannel(resultStart, resultEnd);        //call version of this method that takes in times in seconds
 }
 
+void Wave::BandPass(double lowHz, double highHz)
+//PRE:  0 <= lowHz < highHz
+//POST: Every channel of the wav data has been filtered so that only frequencies between lowHz and highHz
+//      remain. The filtering is done block by block in the frequency domain, so its cost does not grow
+//      with the sharpness of the cutoff. Playback time is unchanged.
+{
+    BandPassFilter filter(lowHz, highHz);       //4096-point blocks: about 11 Hz resolution at 44.1 kHz
+
+    filter.Apply(*this);
+}
+
+void Wave::Convolve(const vector<double>& impulse)
+//PRE:  impulse is not empty and sampled at the sample rate of this wave
+//POST: Every channel of the wav data has been convolved with impulse and scaled down if needed so that no
+//      sample exceeds full scale. The wave grows by impulse.size()-1 samples so that echoes are not cut off.
+{
+    ConvolveChannels(vector<vector<double> >(1, impulse));
+}
+
+void Wave::Convolve(Wave& impulse)
+//PRE:  impulse is initialized and has the same sample rate as this wave
+//POST: Channel n of the wav data has been convolved with channel n of impulse (a mono impulse is used for
+//      every channel) and scaled down if needed so that no sample exceeds full scale. The wave grows by the
+//      length of impulse less one sample so that echoes are not cut off.
+{
+    vector<vector<double> > impulses;                  //one impulse response per channel of impulse
+
+    for (int n=0; n < impulse.GetNumChannels(); n++)
+        impulses.push_back(impulse[n]);
+
+    ConvolveChannels(impulses);
+}
+
 
 void Wave::WriteMovie(int width, int height, int fps)
 //PRE:  width >= 256, 0 < height > 0, width and height measured in pixels, fps > 0
@@ -276,6 +328,57 @@ void Wave::WriteWaveForm(int width, int height, bool drawTicks)
     turtles = NULL;
 }
 
+void Wave::WriteSpectrogram(int width, int height, int fftSize, WindowType window)
+//PRE:  width > 0, height > 0, fftSize is a power of 2, Assigned(window)
+//POST: Writes a new image of width width and height height showing the short-time spectrum of the Wave Object (all channels
+//      mixed down), time running left to right and frequency running bottom to top from 0 Hz to half the sample rate. Each
+//      column is one frame of fftSize samples, tapered by window. Brightness follows loudness in decibels, from black at 80 dB
+//      below the loudest bin through blue to white. Image is saved to the file name of the wave object, but ending in
+//      _spectrogram.bmp.
+{
+    int hopSize = samplesPerChannel/width;      //samples between frames, chosen so that each column of the image is one frame
+    if (hopSize < 1)
+        hopSize = 1;
+
+    cout << "Writing Spectrogram...\n";         //Display friendly progress message
+
+    Spectrogram spectrum(*this, fftSize, hopSize, window);     //the spectrum of every frame, all channels mixed down
+    Image myImage(width, height, 0, true);                      //Create an image of size width x height on a black background.
+    double level;                                               //loudness of one pixel, from 0 (silent) to 1 (loudest bin)
+    double loudest = spectrum.GetMaxMagnitude() > 0             //reference magnitude for 0 dB
+                   ? spectrum.GetMaxMagnitude() : 1;
+
+    for (int i=0; i < width; i++)                               //Loop through each column (frame) of the image
+    {
+        Utility::Bar(cout, i, width);                           //...and bar
+        const float* frame = spectrum[i < spectrum.GetNumFrames() ? i : spectrum.GetNumFrames()-1];
+
+        for (int j=0; j < height; j++)                          //Loop through each row, bottom row first
+        {
+            int firstBin = long(j)*spectrum.GetNumBins()/height;    //the bins covered by this row; the loudest one wins
+            int lastBin = long(j+1)*spectrum.GetNumBins()/height;
+            float magnitude = 0;
+
+            for (int bin=firstBin; bin <= lastBin && bin < spectrum.GetNumBins(); bin++)
+                if (frame[bin] > magnitude)
+                    magnitude = frame[bin];
+
+            level = magnitude > 0 ? 1-20*log10(magnitude/loudest)/SPECTRUMFLOOR : 0;   //decibels, rescaled to 0...1
+            if (level < 0)
+                level = 0;
+
+            myImage[i][height-1-j] = level < 0.5                                        //black to blue (0x0088FF) on the
+                                   ? (int(0x88*2*level) << 8) + int(0xFF*2*level)       //  quiet half, blue to white on
+                                   : (int(0xFF*(2*level-1)) << 16)                      //  the loud half
+                                     + (int(0x88+(0xFF-0x88)*(2*level-1)) << 8) + 0xFF;
+        }
+    }
+    Utility::Bar(cout, width, width);           //Progress Bar should be 100% complete
+    cout << endl;
+
+    myImage.Save((fileName.substr(0,fileName.length()-4)+"_spectrogram.bmp").c_str());  //Save the image to fileName[-.ext]_spectrogram.bmp
+}
+
 Wave Wave::Split(int channel)
 //PRE:  channel > numChannels-1
 //POST: A wave object is returned with one channel, that designated by channel and as extracted by calling wave object
@@ -342,6 +445,20 @@ void Wave::Save(const char* fileName)
     outFile.close();                                          //We are done writing. Close the file.
 }
 
+void Wave::AppendPCM(const unsigned char* data, long frames)
+//PRE:  data holds frames frames of 16-bit little endian PCM, the samples of each frame one per channel
+//POST: Those frames follow the audio already in wavData. fileSize, samplesPerChannel, and songLength
+//        count them as though they had been read from a .wav file.
+{
+    for (long i=0; i < frames; i++)
+        for (int j=0; j < numChannels; j++, data += 2)
+            wavData[j].push_back(ChannelAmp(data[0] | (data[1] << 8)));    //little endian: low byte first
+
+    samplesPerChannel += frames;
+    fileSize += frames*numChannels*2;
+    songLength = double(samplesPerChannel)/sampleRate;
+}
+
 string Wave::GetFileName() const
 //POST: FCTVAL == the file name of the wave or song file
 {
@@ -579,6 +696,41 @@ void Wave::Normalize()
     }
 }
 
+void Wave::ConvolveChannels(const vector<vector<double> >& impulses)
+//PRE:  impulses is not empty and none of its members are empty
+//POST: Channel n of the wav data has been convolved with impulses[n % impulses.size()] and scaled down if
+//      needed so that no sample exceeds full scale. samplesPerChannel, songLength, and fileSize have been
+//      updated for the added tail.
+{
+    long longest = 0;                                   //length of the longest impulse, in samples
+    double peak = 0;                                    //largest amplitude after convolving
+
+    for (unsigned int k=0; k < impulses.size(); k++)
+        if (long(impulses[k].size()) > longest)
+            longest = impulses[k].size();
+
+    Convolver convolver(impulses, Convolver::OfflinePartitionSize(longest));    //offline, so latency is no
+                                                                                //  concern: use big partitions
+    samplesPerChannel += longest-1;                     //make room for the tail of the last samples
+    songLength = double(samplesPerChannel)/sampleRate;
+    fileSize = samplesPerChannel*numChannels*2+HEADERSIZE;
+    for (int n=0; n < numChannels; n++)
+        wavData[n].resize(samplesPerChannel, 0.0);
+
+    cout << "Convolving...\n";                          //Display friendly progress message
+    convolver.Apply(*this);
+
+    for (int n=0; n < numChannels; n++)                 //find how loud the result got...
+        for (long i=0; i < samplesPerChannel; i++)
+            if (fabs(wavData[n][i]) > peak)
+                peak = fabs(wavData[n][i]);
+
+    if (peak > 1)                                       //...and bring it back under full scale
+        for (int n=0; n < numChannels; n++)
+            for (long i=0; i < samplesPerChannel; i++)
+                wavData[n][i] /= peak;
+}
+
 void Wave::outputFrame(long sampleNumber, int frameWidth, int frameHeight, int fps)
 //PRE:  0 <= sampleNumber < wavData[i].size() for any value of i s.t. 0 <= i < numChannels
 //         width >= 256, 0 < height > 0, width and height measured in pixels, fps > 0
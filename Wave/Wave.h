@@ -3,6 +3,7 @@
 #include <fstream>
 #include <math.h>
 #include "Song.h"
+#include "Window.h"
 using namespace std;
 
 class Wave
@@ -19,6 +20,11 @@ public:
     //        to the notes of a Song file. fileSize, numChannels, sampleRate, qLevel, samplesPerChannel,
     //        and songLength have been set according to information in theFile.
 
+    Wave(const char* theFile, int sampleRate, int numChannels);
+    //PRE:  sampleRate > 0, numChannels > 0
+    //POST: An empty 16-bit wave of numChannels channels at sampleRate Hz, its file name theFile, for
+    //        audio decoded elsewhere to be added to with AppendPCM.
+
     Wave(Wave& toCopy);
     //PRE: toCopy is initialized
     //POST: FCTVAL == A new wave object is constructed with the same contents as toCopy
@@ -58,6 +64,23 @@ public:
     //      are reversed. If end is equal to -1, the samples in wavData corresponding to the time in seconds
     //      between the "start" time and the end of the wave are reversed.
 
+    void BandPass(double lowHz, double highHz);
+    //PRE:  0 <= lowHz < highHz
+    //POST: Every channel of the wav data has been filtered so that only frequencies between lowHz and highHz
+    //      remain. The filtering is done block by block in the frequency domain, so its cost does not grow
+    //      with the sharpness of the cutoff. Playback time is unchanged.
+
+    void Convolve(const vector<double>& impulse);
+    //PRE:  impulse is not empty and sampled at the sample rate of this wave
+    //POST: Every channel of the wav data has been convolved with impulse and scaled down if needed so that no
+    //      sample exceeds full scale. The wave grows by impulse.size()-1 samples so that echoes are not cut off.
+
+    void Convolve(Wave& impulse);
+    //PRE:  impulse is initialized and has the same sample rate as this wave
+    //POST: Channel n of the wav data has been convolved with channel n of impulse (a mono impulse is used for
+    //      every channel) and scaled down if needed so that no sample exceeds full scale. The wave grows by the
+    //      length of impulse less one sample so that echoes are not cut off.
+
     void WriteMovie(int width=512, int height=192, int fps = 12);
     //PRE:  width >= 256, 0 < height > 0, width and height measured in pixels, fps > 0
     //POST: Several frames of a visualization of the waveform of this wave have been exported to the
@@ -72,6 +95,14 @@ public:
     //      file name of the wave object, but with .bmp extension. If drawTicks is enabled, the white tickmarks will be drawn to the
     //      image at a spacing such that the distance in pixels between two tickmarks corresponds to 1/8th of a second.
 
+    void WriteSpectrogram(int width=2048, int height=256, int fftSize=1024, WindowType window=HANN);
+    //PRE:  width > 0, height > 0, fftSize is a power of 2, Assigned(window)
+    //POST: Writes a new image of width width and height height showing the short-time spectrum of the Wave Object (all channels
+    //      mixed down), time running left to right and frequency running bottom to top from 0 Hz to half the sample rate. Each
+    //      column is one frame of fftSize samples, tapered by window. Brightness follows loudness in decibels, from black at 80 dB
+    //      below the loudest bin through blue to white. Image is saved to the file name of the wave object, but ending in
+    //      _spectrogram.bmp.
+
     Wave Split(int channel);
     //PRE:  channel > numChannels-1
     //POST: A wave object is returned with one channel, that designated by channel and as extracted by calling wave object
@@ -81,6 +112,11 @@ public:
     //POST: The file located at fileName is populated with the sound data in wavData according to the .wav standard
     //      with the appropriate header as required.
     
+    void AppendPCM(const unsigned char* data, long frames);
+    //PRE:  data holds frames frames of 16-bit little endian PCM, the samples of each frame one per channel
+    //POST: Those frames follow the audio already in wavData. fileSize, samplesPerChannel, and songLength
+    //        count them as though they had been read from a .wav file.
+
     string GetFileName() const;
     //POST: FCTVAL == the file name of the wave or song file
 
@@ -143,6 +179,12 @@ private:
     void Normalize();
     //POST: The contents of wavData is scaled down linearly such that its maximum amplitude is DEFAMPLITUDE
 
+    void ConvolveChannels(const vector<vector<double> >& impulses);
+    //PRE:  impulses is not empty and none of its members are empty
+    //POST: Channel n of the wav data has been convolved with impulses[n % impulses.size()] and scaled down if
+    //      needed so that no sample exceeds full scale. samplesPerChannel, songLength, and fileSize have been
+    //      updated for the added tail.
+
     void outputFrame(long sampleNumber, int frameWidth, int frameHeight, int fps);
     //PRE:  0 <= sampleNumber < wavData[i].size() for any value of i s.t. 0 <= i < numChannels
     //         width >= 256, 0 < height > 0, width and height measured in pixels, fps > 0
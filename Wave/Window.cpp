@@ -0,0 +1,83 @@
+// Window class: Tables of window functions used to taper a block of samples before
+//               taking its Fourier transform.
+
+#include "Window.h"
+#include <map>
+#include <mutex>
+#include <utility>
+#include <math.h>
+using namespace std;
+
+const double Window::KAISER_BETA = 9.0;
+
+const vector<double>& Window::Table(WindowType type, int size)
+// PRE:  Assigned(type), size > 0
+// POST: FCTVAL == size coefficients of the window function type, where coefficient i
+//                 is the weight to multiply the ith sample of a block by. Each table is
+//                 computed the first time it is asked for and shared by every later caller.
+{
+    static map<pair<int, int>, vector<double> > tables;   //every table built so far, by type and size
+    static mutex tablesLock;                                //tables may be asked for from several threads
+
+    lock_guard<mutex> lock(tablesLock);
+    vector<double>& table = tables[make_pair(int(type), size)];    //entries never move once inserted, so
+                                                                    //  the reference stays good after unlocking
+    if (table.empty())                                      //first request for this table: fill it in
+    {
+        table.resize(size);
+        for (int i=0; i < size; i++)
+            table[i] = Coefficient(type, i, size);
+    }
+
+    return table;
+}
+
+double Window::Coefficient(WindowType type, int i, int size)
+// PRE:  Assigned(type), 0 <= i < size
+// POST: FCTVAL == the ith coefficient of a window of type type that is size samples long
+{
+    double phase = size > 1                 //fraction of a full cosine period we are into the
+                 ? 2*M_PI*i/(size-1)        //  window. (Symmetric windows, so the first and last
+                 : 0;                       //  coefficients match.)
+
+    switch(type)
+    {
+        case HANN:
+            return 0.5-0.5*cos(phase);
+        case HAMMING:
+            return 0.54-0.46*cos(phase);
+        case BLACKMAN_HARRIS:               //4-term Blackman-Harris: side lobes 92 dB down
+            return 0.35875-0.48829*cos(phase)+0.14128*cos(2*phase)-0.01168*cos(3*phase);
+        case KAISER:
+            return Kaiser(i, size, KAISER_BETA);
+        default:                            //rectangular window: leave every sample alone
+            return 1.0;
+    }
+}
+
+double Window::Kaiser(int i, int size, double beta)
+// PRE:  0 <= i < size, beta >= 0
+// POST: FCTVAL == the ith coefficient of a Kaiser window of shape beta that is size samples
+//                 long. Larger beta trades a wider main lobe for lower side lobes.
+{
+    double x = size > 1                     //position in the window, from -1 at the first
+             ? 2.0*i/(size-1)-1             //  coefficient to 1 at the last
+             : 0;
+
+    return BesselI0(beta*sqrt(1-x*x))/BesselI0(beta);
+}
+
+double Window::BesselI0(double x)
+// POST: FCTVAL == the zeroth-order modified Bessel function of the first kind at x
+{
+    double sum = 1;                         //running sum of the power series
+    double term = 1;                        //current term, ((x/2)^k/k!)^2
+
+    for (int k=1; term > sum*1e-12; k++)    //terms shrink quickly once k passes x/2
+    {
+        term *= (x/(2*k))*(x/(2*k));
+        sum += term;
+    }
+
+    return sum;
+}
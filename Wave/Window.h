@@ -0,0 +1,35 @@
+// Window class: Tables of window functions used to taper a block of samples before
+//               taking its Fourier transform.
+
+#pragma once
+#include <vector>
+using namespace std;
+
+// All window functions we know how to build. RECTANGULAR leaves the block untouched
+//   (the implicit window used by a plain FFT).
+enum WindowType{RECTANGULAR = 0, HANN = 1, HAMMING = 2, BLACKMAN_HARRIS = 3, KAISER = 4};
+
+class Window
+{
+public:
+    static const vector<double>& Table(WindowType type, int size);
+    // PRE:  Assigned(type), size > 0
+    // POST: FCTVAL == size coefficients of the window function type, where coefficient i
+    //                 is the weight to multiply the ith sample of a block by. Each table is
+    //                 computed the first time it is asked for and shared by every later caller.
+
+    static double Coefficient(WindowType type, int i, int size);
+    // PRE:  Assigned(type), 0 <= i < size
+    // POST: FCTVAL == the ith coefficient of a window of type type that is size samples long
+
+    static double Kaiser(int i, int size, double beta);
+    // PRE:  0 <= i < size, beta >= 0
+    // POST: FCTVAL == the ith coefficient of a Kaiser window of shape beta that is size samples
+    //                 long. Larger beta trades a wider main lobe for lower side lobes.
+
+    static const double KAISER_BETA;        //shape of the KAISER window type (about 90 dB side lobes)
+
+private:
+    static double BesselI0(double x);
+    // POST: FCTVAL == the zeroth-order modified Bessel function of the first kind at x
+};
@@ -0,0 +1,155 @@
+// WaveShader: Draws the waveform visualizations on the graphics card. Only the raw samples of a
+//             frame are uploaded; the vertex shader (Shaders/wave.vert) works out where each one
+//             goes, including the scrolling sine offset and the placement of each channel. Samples
+//             are uploaded in sets of numSamples pairs, one value for each edge of a strip, so a
+//             single set can be drawn as a filled strip, as either of its edges, or as an outline.
+
+#include "WaveShader.h"
+using namespace std;
+
+WaveShader::WaveShader() : slots(QGLBuffer::VertexBuffer), outline(QGLBuffer::IndexBuffer),
+                           samples(QGLBuffer::VertexBuffer)
+// POST: A shader that is not ready to draw
+{
+    numSamples = 0;
+    ready = false;
+}
+
+bool WaveShader::Create()
+// PRE:  The OpenGL context that will draw with this shader is current
+// POST: The shader program has been compiled and linked. FCTVAL == IsReady()
+{
+    ready = QGLShaderProgram::hasOpenGLShaderPrograms()
+         && program.addShaderFromSourceFile(QGLShader::Vertex, ":/Shaders/wave.vert")
+         && program.addShaderFromSourceFile(QGLShader::Fragment, ":/Shaders/wave.frag")
+         && program.link()
+         && slots.create() && outline.create() && samples.create();
+
+    if (ready)
+    {
+        slotLocation = program.attributeLocation("slot");
+        sampleLocation = program.attributeLocation("amplitude");
+        slots.setUsagePattern(QGLBuffer::StaticDraw);       //rebuilt only when the frame size changes
+        outline.setUsagePattern(QGLBuffer::StaticDraw);
+        samples.setUsagePattern(QGLBuffer::StreamDraw);     //rewritten every frame
+    }
+
+    return ready;
+}
+
+bool WaveShader::IsReady() const
+// POST: FCTVAL == true iff Create succeeded, so the graphics card can draw waveforms. When false,
+//                 waveforms must be drawn some other way.
+{
+    return ready;
+}
+
+void WaveShader::Begin(int numSamples, GLfloat xScale, GLfloat phaseShift)
+// PRE:  IsReady(), numSamples > 1
+// POST: The shader is bound for drawing frames of numSamples samples, xScale pixels apart, with the
+//       sine offset shifted by phaseShift radians.
+{
+    if (numSamples != this->numSamples)             //new frame size: rebuild the fixed buffers
+    {
+        vector<GLfloat> slotData(4*numSamples);     //two vertices, one per edge, for every sample
+        vector<GLuint> outlineData;                 //edge 1 left to right, then edge 0 right to left
+
+        for (int v=0; v < 2*numSamples; v++)
+        {
+            slotData[2*v] = v/2;
+            slotData[2*v+1] = v%2;
+        }
+
+        for (int i=0; i < numSamples; i++)
+            outlineData.push_back(2*i+1);
+        outlineData.push_back(2*numSamples-2);
+        outlineData.push_back(0);
+
+        slots.bind();
+        slots.allocate(&slotData[0], slotData.size()*sizeof(GLfloat));
+        slots.release();
+        outline.bind();
+        outline.allocate(&outlineData[0], outlineData.size()*sizeof(GLuint));
+        outline.release();
+
+        this->numSamples = numSamples;
+    }
+
+    program.bind();
+    program.setUniformValue("numSamples", GLfloat(numSamples));
+    program.setUniformValue("xScale", xScale);
+    program.setUniformValue("phaseShift", phaseShift);
+    program.enableAttributeArray(slotLocation);
+    program.enableAttributeArray(sampleLocation);
+}
+
+void WaveShader::Upload(const vector<GLfloat>& pairs)
+// PRE:  Between Begin and End, pairs holds 2*numSamples values for each set: sample i of a set is
+//       pairs[2*i] on edge 0 and pairs[2*i+1] on edge 1.
+// POST: The samples have been sent to the graphics card, replacing those of the last upload.
+{
+    samples.bind();
+    samples.allocate(&pairs[0], pairs.size()*sizeof(GLfloat));
+    samples.release();
+}
+
+void WaveShader::Layout(int edge, GLfloat center, GLfloat sineScale, GLfloat sampleScale)
+// PRE:  Between Begin and End, edge is 0 or 1
+// POST: Vertices on edge edge are drawn at height center+sineScale*sin(...)+sampleScale*sample.
+{
+    program.setUniformValue(edge == 0 ? "edge0" : "edge1", QVector3D(center, sineScale, sampleScale));
+}
+
+void WaveShader::Color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+// PRE:  Between Begin and End
+// POST: Everything drawn from now on is colored (red, green, blue, alpha).
+{
+    program.setUniformValue("color", red, green, blue, alpha);
+}
+
+void WaveShader::DrawStrip(int set)
+// PRE:  Between Begin and End, set was uploaded
+// POST: The area between the two edges of set has been filled in.
+{
+    Point(set, 0, 1);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 2*numSamples);
+}
+
+void WaveShader::DrawEdge(int set, int edge, int first)
+// PRE:  Between Begin and End, set was uploaded, edge is 0 or 1, 0 <= first < numSamples
+// POST: A line has been drawn through samples first..numSamples-1 of edge edge of set.
+{
+    Point(set, edge, 2);                            //every other vertex is on this edge
+    glDrawArrays(GL_LINE_STRIP, first, numSamples-first);
+}
+
+void WaveShader::DrawOutline(int set)
+// PRE:  Between Begin and End, set was uploaded
+// POST: A closed line has been drawn along edge 1 of set, down to the last sample of edge 0, across
+//       to its first sample, and back up to the start of edge 1.
+{
+    Point(set, 0, 1);
+    outline.bind();
+    glDrawElements(GL_LINE_LOOP, numSamples+2, GL_UNSIGNED_INT, NULL);
+    outline.release();
+}
+
+void WaveShader::End()
+// POST: The shader and its buffers are unbound, so fixed-function drawing can resume.
+{
+    program.disableAttributeArray(sampleLocation);
+    program.disableAttributeArray(slotLocation);
+    program.release();
+}
+
+void WaveShader::Point(int set, int edge, int stride)
+// PRE:  Between Begin and End
+// POST: The slot and sample attributes read every stride-th vertex of set, starting at edge edge.
+{
+    slots.bind();
+    program.setAttributeBuffer(slotLocation, GL_FLOAT, 2*edge*sizeof(GLfloat), 2, 2*stride*sizeof(GLfloat));
+    samples.bind();
+    program.setAttributeBuffer(sampleLocation, GL_FLOAT, (2*set*numSamples+edge)*sizeof(GLfloat), 1,
+                               stride*sizeof(GLfloat));
+    samples.release();
+}
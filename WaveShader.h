@@ -0,0 +1,74 @@
+// WaveShader: Draws the waveform visualizations on the graphics card. Only the raw samples of a
+//             frame are uploaded; the vertex shader (Shaders/wave.vert) works out where each one
+//             goes, including the scrolling sine offset and the placement of each channel. Samples
+//             are uploaded in sets of numSamples pairs, one value for each edge of a strip, so a
+//             single set can be drawn as a filled strip, as either of its edges, or as an outline.
+
+#pragma once
+
+#include <QtOpenGL>
+#include <vector>
+using namespace std;
+
+class WaveShader
+{
+public:
+    WaveShader();
+    // POST: A shader that is not ready to draw
+
+    bool Create();
+    // PRE:  The OpenGL context that will draw with this shader is current
+    // POST: The shader program has been compiled and linked. FCTVAL == IsReady()
+
+    bool IsReady() const;
+    // POST: FCTVAL == true iff Create succeeded, so the graphics card can draw waveforms. When false,
+    //                 waveforms must be drawn some other way.
+
+    void Begin(int numSamples, GLfloat xScale, GLfloat phaseShift);
+    // PRE:  IsReady(), numSamples > 1
+    // POST: The shader is bound for drawing frames of numSamples samples, xScale pixels apart, with the
+    //       sine offset shifted by phaseShift radians.
+
+    void Upload(const vector<GLfloat>& pairs);
+    // PRE:  Between Begin and End, pairs holds 2*numSamples values for each set: sample i of a set is
+    //       pairs[2*i] on edge 0 and pairs[2*i+1] on edge 1.
+    // POST: The samples have been sent to the graphics card, replacing those of the last upload.
+
+    void Layout(int edge, GLfloat center, GLfloat sineScale, GLfloat sampleScale);
+    // PRE:  Between Begin and End, edge is 0 or 1
+    // POST: Vertices on edge edge are drawn at height center+sineScale*sin(...)+sampleScale*sample.
+
+    void Color(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha = 1.0);
+    // PRE:  Between Begin and End
+    // POST: Everything drawn from now on is colored (red, green, blue, alpha).
+
+    void DrawStrip(int set);
+    // PRE:  Between Begin and End, set was uploaded
+    // POST: The area between the two edges of set has been filled in.
+
+    void DrawEdge(int set, int edge, int first = 0);
+    // PRE:  Between Begin and End, set was uploaded, edge is 0 or 1, 0 <= first < numSamples
+    // POST: A line has been drawn through samples first..numSamples-1 of edge edge of set.
+
+    void DrawOutline(int set);
+    // PRE:  Between Begin and End, set was uploaded
+    // POST: A closed line has been drawn along edge 1 of set, down to the last sample of edge 0, across
+    //       to its first sample, and back up to the start of edge 1.
+
+    void End();
+    // POST: The shader and its buffers are unbound, so fixed-function drawing can resume.
+
+private:
+    void Point(int set, int edge, int stride);
+    // PRE:  Between Begin and End
+    // POST: The slot and sample attributes read every stride-th vertex of set, starting at edge edge.
+
+    QGLShaderProgram program;               //wave.vert and wave.frag, linked
+    QGLBuffer slots;                        //(sample number, edge) of each vertex of a set; fixed per numSamples
+    QGLBuffer outline;                      //vertex numbers visited by DrawOutline; fixed per numSamples
+    QGLBuffer samples;                      //streaming buffer holding the sets uploaded this frame
+    int numSamples;                         //samples per set that slots and outline were built for
+    int slotLocation;                       //attribute locations in program
+    int sampleLocation;
+    bool ready;                             //true once Create has succeeded
+};
@@ -2,15 +2,139 @@
 // Summer 2009, Evan Fox and Doug Hogan
 
 #include <QApplication>
+#include <QStringList>
 #include <iostream>
 #include "MainWindow.h"
+#include "OffscreenRenderer.h"
+#include "VideoExporter.h"
+
+int RenderFromCommandLine(const QStringList& args);
+//PRE: args holds the command line, including "--render" or "--export"
+//POST: The frames asked for on the command line have been rendered offscreen, or the video exported
+//      (see below). FCTVAL == 0 on success, nonzero if the arguments were bad or rendering failed
 
 int main(int argc, char** argv)
 {
 	QApplication app(argc, argv);               //application context which holds the program
+
+	if (app.arguments().contains("--render")    //render frames or a video offscreen instead of
+	    || app.arguments().contains("--export"))    //  opening the player
+		return RenderFromCommandLine(app.arguments());
+
 	MainWindow test(0);                         //the main user interface window (not yet visible)
-    
+
 	test.resize(750,450);                       //size the window to 750 pixels wide by 450 pixels high
 	test.show();                                //make window visible
 	return app.exec();                          //run the program!
 }
+
+int RenderFromCommandLine(const QStringList& args)
+//PRE: args holds the command line, including "--render" or "--export"
+//POST: The frames asked for on the command line have been rendered offscreen, or the video exported
+//      (see below). FCTVAL == 0 on success, nonzero if the arguments were bad or rendering failed
+{
+	QString fileName;                           //.wav file to visualize
+	bool exporting = false;                     //true to write a video rather than timing frames
+	int vis = 0;                                //which visualization to render
+	int first = 0;                              //first and last frame to render; -1 for the end of the song
+	int last = -1;
+	int fps = DEFAULT_FRAME_RATE;               //frames per second of audio
+	int width = FRAME_WIDTH;                    //size of each frame in pixels
+	int height = FRAME_HEIGHT;
+	string prefix;                              //where frames (or the video) are saved; empty to only time them
+	bool ok = true;                             //false once an argument is bad
+
+	for (int i=1; i < args.size() && ok; i++)   //each option takes one value
+	{
+		QString value = i+1 < args.size() ? args[i+1] : QString();
+		bool valid = !value.isEmpty();          //false if value does not parse
+
+		if (args[i] == "--render" || args[i] == "--export")
+		{
+			fileName = value;
+			exporting = args[i] == "--export";
+		}
+		else if (args[i] == "--vis")
+			vis = value.toInt(&valid);
+		else if (args[i] == "--frames")         //a single frame or a range, first-last
+		{
+			QStringList range = value.split('-');
+			bool validLast = true;
+			first = range[0].toInt(&valid);
+			last = range.size() > 1 ? range[1].toInt(&validLast) : first;
+			valid = valid && validLast && range.size() <= 2;
+		}
+		else if (args[i] == "--fps")
+		{
+			fps = value.toInt(&valid);
+			valid = valid && fps > 0;
+		}
+		else if (args[i] == "--size")           //widthxheight
+		{
+			QStringList size = value.split('x');
+			bool validHeight = false;
+			width = size[0].toInt(&valid);
+			height = size.size() == 2 ? size[1].toInt(&validHeight) : 0;
+			valid = valid && validHeight && width > 0 && height > 0;
+		}
+		else if (args[i] == "--out")
+			prefix = value.toStdString();
+		else
+			valid = false;
+
+		ok = valid;
+		i++;                                    //skip the value
+	}
+
+	GLWidget choices(0);                        //never shown; only asked which visualizations there are
+	int lastVis = choices.GetNumVisualizations()-1;
+
+	if (!ok || fileName.isEmpty() || vis < 0 || vis > lastVis || (exporting && prefix.empty()))
+	{
+		cerr << "Usage: GLUI --render song.wav [--vis 0-" << lastVis << "] [--frames first[-last]]" << endl
+		     << "                             [--fps frames per second] [--size widthxheight] [--out prefix]" << endl
+		     << "       GLUI --export song.wav --out video [--vis 0-" << lastVis << "]" << endl
+		     << "                             [--fps frames per second] [--size widthxheight]" << endl
+		     << "--render renders frames of a visualization offscreen and reports how long they took. With --out," << endl
+		     << "frame n is saved as prefix plus n in five digits, e.g. prefix00042.png." << endl
+		     << "--export writes the whole song as one video: raw RGB if video ends in .rgb, YUV4MPEG2 if it" << endl
+		     << "ends in .y4m, otherwise whatever ffmpeg makes of the extension, with the song's audio." << endl
+		     << "Without a display, run under xvfb-run; set LIBGL_ALWAYS_SOFTWARE=1 to use Mesa's software driver." << endl
+		     << "--vis picks one of:" << endl;
+		for (int i=0; i <= lastVis; i++)
+			cerr << "  " << i << "  " << choices.GetVisualizationName(i) << endl;
+		return 2;
+	}
+
+	Wave song(fileName.toStdString().c_str());  //the song to visualize
+
+	if (exporting)
+	{
+		VideoExporter exporter(&song, width, height);
+
+		if (!exporter.IsReady())
+		{
+			cerr << "This OpenGL driver cannot render offscreen (no framebuffer objects)." << endl;
+			return 1;
+		}
+		return exporter.Export(vis, fps, prefix, cout) ? 0 : 1;
+	}
+
+	OffscreenRenderer renderer(&song, width, height);
+
+	if (!renderer.IsReady())
+	{
+		cerr << "This OpenGL driver cannot render offscreen (no framebuffer objects)." << endl;
+		return 1;
+	}
+
+	if (last < 0 || last >= renderer.GetNumFrames(fps))  //clamp the range to the song
+		last = renderer.GetNumFrames(fps)-1;
+	if (first < 0 || first > last)
+	{
+		cerr << "The song has only " << renderer.GetNumFrames(fps) << " frames at " << fps << " fps." << endl;
+		return 1;
+	}
+
+	return renderer.RenderRange(vis, first, last, fps, prefix, cout) ? 0 : 1;
+}